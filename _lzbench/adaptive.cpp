@@ -0,0 +1,203 @@
+// per-chunk codec selection ("adaptive" pseudo-codec)
+
+#include "adaptive.h"
+#include "isa.h"
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADAPTIVE_STORED_ENTROPY 7.5  // heuristic: store chunks with a higher order-0 entropy
+#define ADAPTIVE_FAST_ENTROPY 6.0    // heuristic: use the first (fastest) candidate above this entropy
+#define ADAPTIVE_STORED_RATIO 0.98   // sampling: store chunks whose best sample ratio is higher
+#define ADAPTIVE_SAMPLE_BOUND (ADAPTIVE_SAMPLE_SIZE*2 + 64*1024)
+#define SAMPLE_LEN(insize) ((insize) < ADAPTIVE_SAMPLE_SIZE ? (insize) : ADAPTIVE_SAMPLE_SIZE)
+
+enum { SELECT_HEURISTIC=1, SELECT_SAMPLING, SELECT_COST };
+
+static adaptive_candidate_t adaptive_candidates[ADAPTIVE_MAX_CANDIDATES];
+static size_t adaptive_count = 0;
+static uint32_t adaptive_link = ADAPTIVE_DEFAULT_LINK;
+static int adaptive_isa = ISA_BASE;
+
+typedef struct
+{
+    int selector;
+    adaptive_candidate_t cand[ADAPTIVE_MAX_CANDIDATES];  // with the functions of the ISA at init
+    char* workmem[ADAPTIVE_MAX_CANDIDATES];
+    char* sample;
+} adaptive_state_t;
+
+
+bool adaptive_add_candidate(const adaptive_candidate_t* cand)
+{
+    if (adaptive_count >= ADAPTIVE_MAX_CANDIDATES || !cand->compress || !cand->decompress) return false;
+    adaptive_candidates[adaptive_count++] = *cand;
+    return true;
+}
+
+
+void adaptive_clear_candidates()
+{
+    adaptive_count = 0;
+}
+
+
+size_t adaptive_candidates_count()
+{
+    return adaptive_count;
+}
+
+
+const adaptive_candidate_t* adaptive_get_candidate(int idx)
+{
+    return &adaptive_candidates[idx];
+}
+
+
+void adaptive_set_link(uint32_t mbps)
+{
+    adaptive_link = mbps ? mbps : 1;
+}
+
+
+uint32_t adaptive_get_link()
+{
+    return adaptive_link;
+}
+
+
+void adaptive_set_isa(int isa)
+{
+    adaptive_isa = isa;
+}
+
+
+static double sample_entropy(const uint8_t* in, size_t n)
+{
+    uint32_t count[256];
+    double bits = 0;
+
+    memset(count, 0, sizeof(count));
+    for (size_t i=0; i<n; i++) count[in[i]]++;
+    for (int i=0; i<256; i++)
+        if (count[i]) bits -= count[i] * log2((double)count[i] / n);
+    return n ? bits / n : 0;
+}
+
+
+/* the sample is taken from the middle of the chunk, headers at the start are often not representative */
+static int select_by_sample(adaptive_state_t* state, const uint8_t* in, size_t insize, bool cost_model)
+{
+    size_t n = SAMPLE_LEN(insize);
+    char* sample = (char*)in + (insize - n) / 2;
+    double best_cost = 0;
+    int best = ADAPTIVE_STORED;
+
+    for (size_t i=0; i<adaptive_count; i++)
+    {
+        adaptive_candidate_t* cand = &state->cand[i];
+        auto start = std::chrono::steady_clock::now();
+        int64_t clen = cand->compress(sample, n, state->sample, ADAPTIVE_SAMPLE_BOUND, cand->level, cand->param2, state->workmem[i]);
+        auto end = std::chrono::steady_clock::now();
+        if (clen <= 0 || clen >= n * ADAPTIVE_STORED_RATIO) continue;
+
+        // cost model: compression time + time to send the output, both in microseconds
+        double cost = clen;
+        if (cost_model)
+            cost = std::chrono::duration<double, std::micro>(end - start).count() + (double)clen / adaptive_link;
+        if (best == ADAPTIVE_STORED || cost < best_cost) { best = i; best_cost = cost; }
+    }
+    return best;
+}
+
+
+int adaptive_select(char* workmem, const uint8_t* in, size_t insize)
+{
+    adaptive_state_t* state = (adaptive_state_t*)workmem;
+
+    if (!adaptive_count) return ADAPTIVE_STORED;
+
+    switch (state->selector)
+    {
+        default:
+        case SELECT_HEURISTIC:
+        {
+            double h = sample_entropy(in + (insize - SAMPLE_LEN(insize)) / 2, SAMPLE_LEN(insize));
+            if (h > ADAPTIVE_STORED_ENTROPY) return ADAPTIVE_STORED;
+            return (h > ADAPTIVE_FAST_ENTROPY) ? 0 : adaptive_count - 1;
+        }
+        case SELECT_SAMPLING:
+            return select_by_sample(state, in, insize, false);
+        case SELECT_COST:
+            return select_by_sample(state, in, insize, true);
+    }
+}
+
+
+int64_t adaptive_compress_with(char* workmem, int idx, char *in, size_t insize, char *out, size_t outsize)
+{
+    adaptive_state_t* state = (adaptive_state_t*)workmem;
+    adaptive_candidate_t* cand = &state->cand[idx];
+
+    return cand->compress(in, insize, out, outsize, cand->level, cand->param2, state->workmem[idx]);
+}
+
+
+char* lzbench_adaptive_init(size_t insize, size_t level, size_t)
+{
+    adaptive_state_t* state = (adaptive_state_t*)calloc(1, sizeof(adaptive_state_t));
+    if (!state) return NULL;
+
+    state->selector = level;
+    state->sample = (char*)malloc(ADAPTIVE_SAMPLE_BOUND);
+    for (size_t i=0; i<adaptive_count; i++)
+    {
+        adaptive_candidate_t* cand = &state->cand[i];
+        *cand = adaptive_candidates[i];
+        cand->compress = (decltype(cand->compress))isa_variant(adaptive_isa, (isa_func_t)cand->compress);
+        cand->decompress = (decltype(cand->decompress))isa_variant(adaptive_isa, (isa_func_t)cand->decompress);
+        cand->init = (decltype(cand->init))isa_variant(adaptive_isa, (isa_func_t)cand->init);
+        cand->deinit = (decltype(cand->deinit))isa_variant(adaptive_isa, (isa_func_t)cand->deinit);
+        if (cand->init) state->workmem[i] = cand->init(insize, cand->level, cand->param2);
+    }
+    return (char*)state;
+}
+
+
+void lzbench_adaptive_deinit(char* workmem)
+{
+    adaptive_state_t* state = (adaptive_state_t*)workmem;
+    if (!state) return;
+
+    for (size_t i=0; i<adaptive_count; i++)
+        if (state->cand[i].deinit)
+            state->cand[i].deinit(state->workmem[i]);
+    free(state->sample);
+    free(state);
+}
+
+
+int64_t lzbench_adaptive_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    if (!workmem || outsize < 2) return 0;
+
+    int idx = adaptive_select(workmem, (uint8_t*)inbuf, insize);
+    if (idx == ADAPTIVE_STORED) return 0;
+
+    int64_t clen = adaptive_compress_with(workmem, idx, inbuf, insize, outbuf + 1, outsize - 1);
+    if (clen <= 0 || clen + 1 >= insize) return 0; // lzbench stores the chunk, a size equal to insize means uncompressed
+    outbuf[0] = (char)idx;
+    return clen + 1;
+}
+
+
+int64_t lzbench_adaptive_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    adaptive_state_t* state = (adaptive_state_t*)workmem;
+    size_t idx = (uint8_t)inbuf[0];
+
+    if (!state || insize < 1 || idx >= adaptive_count) return 0;
+    adaptive_candidate_t* cand = &state->cand[idx];
+    return cand->decompress(inbuf + 1, insize - 1, outbuf, outsize, cand->level, cand->param2, state->workmem[idx]);
+}
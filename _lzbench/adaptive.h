@@ -0,0 +1,48 @@
+#ifndef LZBENCH_ADAPTIVE_H
+#define LZBENCH_ADAPTIVE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * "adaptive" pseudo-codec: each chunk is compressed with one of the registered candidates,
+ * chosen by the selector given as the level:
+ *   1 = heuristic (order-0 entropy of a sample: stored, first candidate or last candidate)
+ *   2 = sampling (the candidate that compresses a sample best)
+ *   3 = cost model (sampled ratio and speed, minimizes compression time + transfer time over a link)
+ * The compressed chunk starts with a byte holding the candidate number, chunks that do not
+ * compress are left to lzbench to store uncompressed.
+ */
+typedef struct
+{
+    const char* name;
+    int level;
+    size_t param2;
+    int64_t (*compress)(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*);
+    int64_t (*decompress)(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*);
+    char* (*init)(size_t insize, size_t, size_t);
+    void (*deinit)(char* workmem);
+} adaptive_candidate_t;
+
+#define ADAPTIVE_MAX_CANDIDATES 16
+#define ADAPTIVE_SAMPLE_SIZE (16*1024)  // bytes compressed by each candidate in the sampling and cost model selectors
+#define ADAPTIVE_DEFAULT_LINK 100       // MB/s, link speed of the cost model
+#define ADAPTIVE_STORED -1              // adaptive_select() result for chunks left uncompressed
+
+bool adaptive_add_candidate(const adaptive_candidate_t* cand);
+void adaptive_clear_candidates();
+size_t adaptive_candidates_count();
+const adaptive_candidate_t* adaptive_get_candidate(int idx);
+void adaptive_set_link(uint32_t mbps);
+uint32_t adaptive_get_link();
+void adaptive_set_isa(int isa);  // isa_e of the candidates of the next lzbench_adaptive_init()
+
+int adaptive_select(char* workmem, const uint8_t* in, size_t insize);
+int64_t adaptive_compress_with(char* workmem, int idx, char *in, size_t insize, char *out, size_t outsize);
+
+char* lzbench_adaptive_init(size_t insize, size_t level, size_t);
+void lzbench_adaptive_deinit(char* workmem);
+int64_t lzbench_adaptive_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem);
+int64_t lzbench_adaptive_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem);
+
+#endif
@@ -0,0 +1,171 @@
+// worst-case inputs, stream mutations and the guarded decoder runs of the --adversarial option
+
+#include "adversarial.h"
+#include <string.h>
+
+#if !defined(_WIN32)
+    #include <unistd.h>     // fork, pipe, alarm
+    #include <signal.h>
+    #include <sys/wait.h>
+    #define ADVERSARIAL_HAS_FORK
+#endif
+
+const char* adv_input_names[ADV_INPUT_COUNT] = { "matches", "literals", "overlap", "huffman", "random" };
+const char* adv_mutation_names[ADV_MUTATION_COUNT] = { "truncate", "bitflip", "bytes" };
+
+
+static inline uint64_t adv_rand(uint64_t* state)
+{
+    // splitmix64
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* copies len bytes from offset back byte by byte, so short offsets repeat the last bytes */
+static inline void adv_copy(uint8_t* buf, size_t pos, size_t offset, size_t len)
+{
+    for (size_t i=0; i<len; i++)
+        buf[pos + i] = buf[pos + i - offset];
+}
+
+void adv_generate(adv_input_e kind, uint8_t* buf, size_t size, uint64_t seed)
+{
+    uint64_t state = seed;
+    size_t pos = 0;
+
+    switch (kind)
+    {
+    case ADV_MATCHES:
+    case ADV_LITERALS:
+        // 4-byte matches (the minimum of most LZ formats) at random offsets up to 64 KB, with no literals
+        // in between or with one literal before each match
+        for (; pos < size && pos < 64; pos++) buf[pos] = (uint8_t)adv_rand(&state);
+        while (pos < size)
+        {
+            uint64_t r = adv_rand(&state);
+            if (kind == ADV_LITERALS) buf[pos++] = (uint8_t)(r >> 32);
+            size_t len = (size - pos < 4) ? size - pos : 4;
+            size_t window = (pos < 65535) ? pos : 65535;
+            adv_copy(buf, pos, 4 + (r & 0xFFFF) % (window - 3), len);
+            pos += len;
+        }
+        break;
+    case ADV_OVERLAP:
+        // copies with offsets 1-8 that overlap their own output, 16-79 bytes long, after a single literal
+        for (; pos < size && pos < 8; pos++) buf[pos] = (uint8_t)adv_rand(&state);
+        while (pos < size)
+        {
+            uint64_t r = adv_rand(&state);
+            buf[pos++] = (uint8_t)(r >> 32);
+            size_t len = (size - pos < 16 + ((r >> 8) & 63)) ? size - pos : 16 + ((r >> 8) & 63);
+            adv_copy(buf, pos, 1 + (r & 7), len);
+            pos += len;
+        }
+        break;
+    case ADV_HUFFMAN:
+    {
+        // all 256 symbols, then symbol k with probability 2^-(k+1): the deepest code every coder's length limit allows
+        uint8_t perm[256];
+        for (int i=0; i<256; i++) perm[i] = (uint8_t)i;
+        for (int i=255; i>0; i--)
+        {
+            int j = adv_rand(&state) % (i + 1);
+            uint8_t t = perm[i]; perm[i] = perm[j]; perm[j] = t;
+        }
+        for (; pos < size && pos < 256; pos++) buf[pos] = perm[pos];
+        for (; pos < size; pos++)
+        {
+            uint64_t r = adv_rand(&state);
+            int k = 0;
+            while (k < 63 && !(r & 1)) { r >>= 1; k++; }
+            buf[pos] = perm[k];
+        }
+        break;
+    }
+    default:
+        for (; pos < size; pos++) buf[pos] = (uint8_t)adv_rand(&state);
+        break;
+    }
+}
+
+
+size_t adv_mutate(adv_mutation_e kind, const uint8_t* in, size_t insize, uint8_t* out, uint64_t seed)
+{
+    uint64_t state = seed;
+
+    memcpy(out, in, insize);
+    if (!insize) return 0;
+    switch (kind)
+    {
+    case ADV_TRUNCATE:
+        return adv_rand(&state) % insize;
+    case ADV_BITFLIP:
+        for (int n = 1 + adv_rand(&state) % 8; n > 0; n--)
+        {
+            uint64_t r = adv_rand(&state);
+            out[(r >> 3) % insize] ^= (uint8_t)(1 << (r & 7));
+        }
+        return insize;
+    default:
+    {
+        // a span of 1-16 random, 0xFF (the largest lengths and counts) or zero bytes
+        uint64_t r = adv_rand(&state);
+        size_t len = 1 + (r & 15), pos = (r >> 8) % insize;
+        int fill = (r >> 4) % 3;
+        for (size_t i=pos; i<pos + len && i<insize; i++)
+            out[i] = (fill == 0) ? (uint8_t)adv_rand(&state) : (fill == 1) ? 0xFF : 0;
+        return insize;
+    }
+    }
+}
+
+
+bool adv_guard_available()
+{
+#ifdef ADVERSARIAL_HAS_FORK
+    return true;
+#else
+    return false;
+#endif
+}
+
+adv_status_e adv_run_guarded(void (*func)(void* arg, void* result), void* arg, void* result, size_t size, unsigned timeout, int* sig)
+{
+    *sig = 0;
+#ifdef ADVERSARIAL_HAS_FORK
+    int fds[2], status;
+    if (pipe(fds) == 0)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(fds[0]);
+            alarm(timeout);
+            func(arg, result);
+            if (write(fds[1], result, size) != (ssize_t)size) _exit(1);
+            _exit(0);
+        }
+        close(fds[1]);
+        if (pid > 0)
+        {
+            size_t got = 0;
+            ssize_t n;
+            while (got < size && (n = read(fds[0], (char*)result + got, size - got)) > 0) got += n;
+            close(fds[0]);
+            waitpid(pid, &status, 0);
+            if (WIFSIGNALED(status))
+            {
+                *sig = WTERMSIG(status);
+                return (*sig == SIGALRM) ? ADV_TIMEOUT : ADV_CRASHED;
+            }
+            return (got == size) ? ADV_OK : ADV_CRASHED;
+        }
+        close(fds[0]);
+    }
+#endif
+    // no fork() or no process left: run in this process
+    func(arg, result);
+    return ADV_OK;
+}
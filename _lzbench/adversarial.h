@@ -0,0 +1,36 @@
+#ifndef LZBENCH_ADVERSARIAL_H
+#define LZBENCH_ADVERSARIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Worst-case inputs and corrupted streams for the --adversarial option. The inputs are compressed by
+ * the codec itself, so its decoder gets valid streams with the most sequences, the shortest literal runs,
+ * overlapping short-offset copies or the deepest Huffman codes. The mutations are applied to the stream
+ * of a real chunk. Decoders run in a child process, so a crash or a runaway decode is reported instead
+ * of taking lzbench down.
+ */
+enum adv_input_e { ADV_MATCHES=0, ADV_LITERALS, ADV_OVERLAP, ADV_HUFFMAN, ADV_RANDOM, ADV_INPUT_COUNT };
+enum adv_mutation_e { ADV_TRUNCATE=0, ADV_BITFLIP, ADV_BYTES, ADV_MUTATION_COUNT };
+enum adv_status_e { ADV_OK=0, ADV_CRASHED, ADV_TIMEOUT };
+
+extern const char* adv_input_names[ADV_INPUT_COUNT];
+extern const char* adv_mutation_names[ADV_MUTATION_COUNT];
+
+#define ADVERSARIAL_MAX_SIZE (1 << 20)   // inputs are the first chunk cut to this size
+#define ADVERSARIAL_DEFAULT_TRIALS 100   // mutated streams per mutation
+#define ADVERSARIAL_TIMEOUT 2            // seconds added to 20x the decode time of the real chunk
+
+void adv_generate(adv_input_e kind, uint8_t* buf, size_t size, uint64_t seed);
+
+/* writes a mutated copy of in to out (at least insize bytes), returns its size */
+size_t adv_mutate(adv_mutation_e kind, const uint8_t* in, size_t insize, uint8_t* out, uint64_t seed);
+
+/* false without fork() (Windows), adv_run_guarded() then calls func in this process */
+bool adv_guard_available();
+
+/* runs func(arg, result) in a child process killed after timeout seconds and copies size bytes of result back */
+adv_status_e adv_run_guarded(void (*func)(void* arg, void* result), void* arg, void* result, size_t size, unsigned timeout, int* sig);
+
+#endif
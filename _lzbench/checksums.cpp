@@ -0,0 +1,118 @@
+// wrappers for the checksums measured by the -H option
+
+#include "checksums.h"
+#include "zlib/zlib.h"
+#include "libdeflate/libdeflate.h"
+
+extern "C"
+{
+    // xz/check/crc32_fast.c, crc64_fast.c
+    uint32_t lzma_crc32(const uint8_t *buf, size_t size, uint32_t crc);
+    uint64_t lzma_crc64(const uint8_t *buf, size_t size, uint64_t crc);
+
+    // zstd/lib/common/xxhash.c and the copies from lz4 and lizard built with XXH_NAMESPACE
+    unsigned int XXH32(const void* input, size_t length, unsigned int seed);
+    unsigned long long XXH64(const void* input, size_t length, unsigned long long seed);
+    unsigned int LZ4_XXH32(const void* input, size_t length, unsigned int seed);
+    unsigned long long LZ4_XXH64(const void* input, size_t length, unsigned long long seed);
+    unsigned int LIZARD_XXH32(const void* input, size_t length, unsigned int seed);
+    unsigned long long LIZARD_XXH64(const void* input, size_t length, unsigned long long seed);
+
+    // zlib_simd/crc32.o and adler32.o, the zlib build with SIMD kernels and Z_PREFIX
+    unsigned long z_crc32(unsigned long crc, const unsigned char *buf, unsigned int len);
+    unsigned long z_adler32(unsigned long adler, const unsigned char *buf, unsigned int len);
+
+    // liblzg/checksum.c
+    unsigned int _LZG_CalcChecksum(const unsigned char *in, unsigned int insize);
+}
+
+
+static uint64_t zlib_crc32(const uint8_t* buf, size_t size)
+{
+    uLong crc = crc32(0L, Z_NULL, 0);
+    // zlib takes 32-bit lengths
+    for (size_t part; size > 0; buf += part, size -= part)
+    {
+        part = (size > (1U << 30)) ? (1U << 30) : size;
+        crc = crc32(crc, buf, part);
+    }
+    return crc;
+}
+
+static uint64_t zlib_adler32(const uint8_t* buf, size_t size)
+{
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (size_t part; size > 0; buf += part, size -= part)
+    {
+        part = (size > (1U << 30)) ? (1U << 30) : size;
+        adler = adler32(adler, buf, part);
+    }
+    return adler;
+}
+
+static uint64_t zlib_simd_crc32(const uint8_t* buf, size_t size)
+{
+    unsigned long crc = 0;
+    for (size_t part; size > 0; buf += part, size -= part)
+    {
+        part = (size > (1U << 30)) ? (1U << 30) : size;
+        crc = z_crc32(crc, buf, part);
+    }
+    return crc;
+}
+
+static uint64_t zlib_simd_adler32(const uint8_t* buf, size_t size)
+{
+    unsigned long adler = 1;
+    for (size_t part; size > 0; buf += part, size -= part)
+    {
+        part = (size > (1U << 30)) ? (1U << 30) : size;
+        adler = z_adler32(adler, buf, part);
+    }
+    return adler;
+}
+
+static uint64_t deflate_crc32(const uint8_t* buf, size_t size) { return libdeflate_crc32(0, buf, size); }
+static uint64_t deflate_adler32(const uint8_t* buf, size_t size) { return libdeflate_adler32(1, buf, size); }
+static uint64_t xz_crc32(const uint8_t* buf, size_t size) { return lzma_crc32(buf, size, 0); }
+static uint64_t xz_crc64(const uint8_t* buf, size_t size) { return lzma_crc64(buf, size, 0); }
+static uint64_t zstd_xxh32(const uint8_t* buf, size_t size) { return XXH32(buf, size, 0); }
+static uint64_t zstd_xxh64(const uint8_t* buf, size_t size) { return XXH64(buf, size, 0); }
+static uint64_t lz4_xxh32(const uint8_t* buf, size_t size) { return LZ4_XXH32(buf, size, 0); }
+static uint64_t lz4_xxh64(const uint8_t* buf, size_t size) { return LZ4_XXH64(buf, size, 0); }
+static uint64_t lizard_xxh32(const uint8_t* buf, size_t size) { return LIZARD_XXH32(buf, size, 0); }
+static uint64_t lizard_xxh64(const uint8_t* buf, size_t size) { return LIZARD_XXH64(buf, size, 0); }
+
+static uint64_t lzg_checksum(const uint8_t* buf, size_t size)
+{
+    unsigned int sum = 0;
+    // the liblzg checksum cannot be continued, it is computed per 1 GB part
+    for (size_t part; size > 0; buf += part, size -= part)
+    {
+        part = (size > (1U << 30)) ? (1U << 30) : size;
+        sum ^= _LZG_CalcChecksum(buf, part);
+    }
+    return sum;
+}
+
+
+const checksum_desc_t checksum_desc[] =
+{
+    { "crc32",          "zlib 1.2.11",      zlib_crc32 },
+    { "adler32",        "zlib 1.2.11",      zlib_adler32 },
+    { "crc32_simd",     "zlib_simd 1.2.11", zlib_simd_crc32 },
+    { "adler32_simd",   "zlib_simd 1.2.11", zlib_simd_adler32 },
+    { "crc32_deflate",  "libdeflate 1.6",   deflate_crc32 },
+    { "adler32_deflate","libdeflate 1.6",   deflate_adler32 },
+    { "crc32_xz",       "xz 5.2.5",         xz_crc32 },
+    { "crc64_xz",       "xz 5.2.5",         xz_crc64 },
+    { "xxh32",          "zstd 1.4.8",       zstd_xxh32 },
+    { "xxh64",          "zstd 1.4.8",       zstd_xxh64 },
+    { "xxh32_lz4",      "lz4 1.9.3",        lz4_xxh32 },
+    { "xxh64_lz4",      "lz4 1.9.3",        lz4_xxh64 },
+    { "xxh32_lizard",   "lizard 1.0",       lizard_xxh32 },
+    { "xxh64_lizard",   "lizard 1.0",       lizard_xxh64 },
+    { "lzg",            "liblzg 1.0.10",    lzg_checksum },
+};
+
+const int checksum_desc_count = sizeof(checksum_desc) / sizeof(checksum_desc[0]);
@@ -0,0 +1,20 @@
+#ifndef LZBENCH_CHECKSUMS_H
+#define LZBENCH_CHECKSUMS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* checksum and hash implementations vendored by the compressors, for the -H option */
+typedef uint64_t (*checksum_func)(const uint8_t* buf, size_t size);
+
+typedef struct
+{
+    const char* name;
+    const char* version;
+    checksum_func func;
+} checksum_desc_t;
+
+extern const checksum_desc_t checksum_desc[];
+extern const int checksum_desc_count;
+
+#endif
@@ -0,0 +1,167 @@
+// baselines and the significance test of the --compare option
+
+#include "compare.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+
+/* the string or number after "key": in a row of print_json(), also with whitespace around the colon as in a
+   re-formatted file, empty if missing */
+static std::string json_value(const char* line, const char* key)
+{
+    std::string k = std::string("\"") + key + "\"", value;
+    const char* p = line;
+
+    while ((p = strstr(p, k.c_str())))
+    {
+        p += k.size();
+        p += strspn(p, " \t\r\n");
+        if (*p == ':') break;
+    }
+    if (!p) return value;
+    p += 1 + strspn(p + 1, " \t\r\n");
+    if (*p == '"')
+    {
+        for (p++; *p && *p != '"'; p++)
+        {
+            if (*p == '\\' && p[1]) p++;
+            value += *p;
+        }
+    }
+    else if (*p == '[')
+        value.assign(p + 1, strcspn(p + 1, "]"));
+    else
+        value.assign(p, strcspn(p, ",}"));
+    return value;
+}
+
+static void json_samples(const std::string& list, std::vector<uint64_t>& samples)
+{
+    const char* p = list.c_str();
+    char* end;
+
+    while (*p)
+    {
+        uint64_t v = strtoull(p, &end, 10);
+        if (end == p) break;
+        samples.push_back(v);
+        p = end + strspn(end, " \t\r\n");
+        if (*p == ',') p++;
+    }
+}
+
+
+/* each innermost {...} object is a row, so the one-line rows of -o7 can also be pretty-printed or in an array */
+bool compare_load(const char* path, std::vector<compare_row_t>& rows)
+{
+    FILE* f = fopen(path, "r");
+    std::string text;
+    size_t start = std::string::npos;
+    bool in_string = false;
+    int c;
+
+    if (!f) return false;
+    while ((c = fgetc(f)) != EOF) text += (char)c;
+    fclose(f);
+
+    for (size_t i=0; i<text.size(); i++)
+    {
+        if (in_string)
+        {
+            if (text[i] == '\\') i++;
+            else if (text[i] == '"') in_string = false;
+            continue;
+        }
+        if (text[i] == '"') in_string = true;
+        else if (text[i] == '{') start = i;
+        else if (text[i] == '}' && start != std::string::npos)
+        {
+            std::string object = text.substr(start, i + 1 - start);
+            const char* o = object.c_str();
+            compare_row_t row;
+            start = std::string::npos;
+            row.encoder = json_value(o, "encoder");
+            if (row.encoder.empty()) continue;
+            row.name = json_value(o, "compressor");
+            row.filename = json_value(o, "filename");
+            row.block_size = strtoull(json_value(o, "block_size").c_str(), NULL, 10);
+            row.compressed_size = strtoull(json_value(o, "compressed_size").c_str(), NULL, 10);
+            json_samples(json_value(o, "compression_samples_ns"), row.csamples);
+            json_samples(json_value(o, "decompression_samples_ns"), row.dsamples);
+            rows.push_back(row);
+        }
+    }
+    return !rows.empty();
+}
+
+
+/* two-sided p-value of U (the pairs with the sample of b larger) from its exact distribution without ties: the counts
+   of the orderings of n1 + n2 samples with each U, built up by adding the largest sample to a or to b */
+static double mann_whitney_exact(size_t n1, size_t n2, double u)
+{
+    size_t max_u = n1 * n2;
+    std::vector<std::vector<double> > counts((n1 + 1) * (n2 + 1));   // [i * (n2 + 1) + j][u] of i and j samples
+
+    for (size_t i=0; i<=n1; i++)
+        for (size_t j=0; j<=n2; j++)
+        {
+            std::vector<double>& c = counts[i * (n2 + 1) + j];
+            c.assign(i * j + 1, 0.0);
+            if (!i || !j) { c[0] = 1; continue; }
+            const std::vector<double>& to_a = counts[(i - 1) * (n2 + 1) + j];   // the largest is in a, U unchanged
+            const std::vector<double>& to_b = counts[i * (n2 + 1) + j - 1];     // in b, larger than all i of a
+            for (size_t k=0; k<to_a.size(); k++) c[k] += to_a[k];
+            for (size_t k=0; k<to_b.size(); k++) c[k + i] += to_b[k];
+        }
+
+    const std::vector<double>& c = counts.back();
+    double total = 0, below = 0, above = 0;
+    for (size_t k=0; k<=max_u; k++)
+    {
+        total += c[k];
+        if (k <= u) below += c[k];
+        if (k >= u) above += c[k];
+    }
+    return std::min(1.0, 2 * std::min(below, above) / total);
+}
+
+
+double mann_whitney(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, double* effect)
+{
+    std::vector<std::pair<uint64_t, int> > all;
+    double n1 = a.size(), n2 = b.size(), n = n1 + n2, rank_b = 0, ties = 0;
+
+    *effect = 0;
+    if (a.size() < COMPARE_MIN_SAMPLES || b.size() < COMPARE_MIN_SAMPLES) return 1.0;
+    for (size_t i=0; i<a.size(); i++) all.push_back(std::make_pair(a[i], 0));
+    for (size_t i=0; i<b.size(); i++) all.push_back(std::make_pair(b[i], 1));
+    std::sort(all.begin(), all.end());
+
+    for (size_t i=0, j; i<all.size(); i=j)
+    {
+        size_t in_b = 0;
+        for (j=i; j<all.size() && all[j].first == all[i].first; j++) in_b += all[j].second;
+        double t = j - i;
+        rank_b += in_b * (i + 1 + j) / 2.0;   // average rank of the tie group
+        ties += t * t * t - t;
+    }
+
+    double u = rank_b - n2 * (n2 + 1) / 2;
+    double sigma = sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (n * (n - 1))));
+    *effect = 2 * u / (n1 * n2) - 1;
+    if (ties == 0 && a.size() <= COMPARE_EXACT_SAMPLES && b.size() <= COMPARE_EXACT_SAMPLES) return mann_whitney_exact(a.size(), b.size(), u);
+    if (sigma == 0) return 1.0;
+    double z = (fabs(u - n1 * n2 / 2) - 0.5) / sigma;   // with continuity correction
+    return (z <= 0) ? 1.0 : erfc(z / sqrt(2.0));
+}
+
+
+uint64_t compare_median(std::vector<uint64_t> samples)
+{
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    return (samples[(samples.size()-1)/2] + samples[samples.size()/2]) / 2;
+}
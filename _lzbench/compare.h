@@ -0,0 +1,37 @@
+#ifndef LZBENCH_COMPARE_H
+#define LZBENCH_COMPARE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * Baselines of the --compare option: the rows an earlier run printed with -o7, where each row has the
+ * timing samples its speeds were selected from. Rows are matched by their -e argument, file and block
+ * size, so a new codec version is compared with the old one. Samples are compared with the two-sided
+ * Mann-Whitney U test, exact for small samples without ties and otherwise the normal approximation with tie
+ * correction. With COMPARE_MIN_SAMPLES per side the smallest exact p-value is 2/252 < COMPARE_ALPHA.
+ */
+#define COMPARE_DEFAULT_THRESHOLD 2.0   // % of speed or size change that fails the run if significant
+#define COMPARE_ALPHA 0.01              // significance level
+#define COMPARE_MIN_SAMPLES 5           // fewer samples on either side are not tested
+#define COMPARE_EXACT_SAMPLES 20        // the exact distribution of U up to this many samples on each side
+
+typedef struct
+{
+    std::string name, encoder, filename;
+    uint64_t block_size, compressed_size;
+    std::vector<uint64_t> csamples, dsamples;
+} compare_row_t;
+
+/* reads the JSON rows of -o7, returns false if the file can't be read or has no row with an encoder */
+bool compare_load(const char* path, std::vector<compare_row_t>& rows);
+
+/* p-value of the samples coming from the same distribution, 1.0 with too few samples;
+   effect is the rank-biserial correlation, > 0 if the samples of b tend to be larger than those of a */
+double mann_whitney(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, double* effect);
+
+uint64_t compare_median(std::vector<uint64_t> samples);
+
+#endif
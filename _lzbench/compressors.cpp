@@ -1,4 +1,5 @@
 #include "compressors.h"
+#include "isa.h"
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h> // memcpy
@@ -23,6 +24,70 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 }
 
 
+/* stores the values of the key=value list of -e (param2 of the codecs with keys) in values[], indexed like keys[]; a value is
+   a number or, for a key with names, the position of the name in its '|' separated list; prints the first bad pair */
+static int lzbench_parse_options(const char* codec, const char* options, int count, const char* const* keys, const char* const* names, int* values)
+{
+    while (options && *options)
+    {
+        size_t keylen = strcspn(options, "="), len = strcspn(options, ",");
+        const char* value = options + keylen + 1;
+        size_t valuelen = len - keylen - 1;
+        int k = 0, v = -1;
+
+        while (k < count && (strlen(keys[k]) != keylen || strncmp(options, keys[k], keylen))) k++;
+        if (keylen < len && k < count && valuelen)
+        {
+            const char* n = names ? names[k] : NULL;
+            for (int i=0; n && v < 0; i++)
+            {
+                size_t nlen = strcspn(n, "|");
+                if (nlen == valuelen && !strncmp(n, value, valuelen)) v = i;
+                n = n[nlen] ? n + nlen + 1 : NULL;
+            }
+            if (v < 0 && strspn(value, "0123456789") == valuelen) v = atoi(value);
+            if (v >= 0)
+            {
+                values[k] = v;
+                options += len + (options[len] == ',');
+                continue;
+            }
+        }
+        printf("%s: invalid parameter %.*s\n", codec, (int)len, options);
+        return 0;
+    }
+    return 1;
+}
+
+/* the parsed values of the codecs that keep them in workmem, -1 for the keys not given; rejects the values outside
+   the [min, max] of their key in ranges[] */
+static int* lzbench_options_init(const char* codec, size_t options, int count, const char* const* keys, const char* const* names,
+    const int (*ranges)[2])
+{
+    int* values = (int*)malloc(count * sizeof(int));
+    if (!values) return NULL;
+    for (int k=0; k<count; k++) values[k] = -1;
+    if (!lzbench_parse_options(codec, (const char*)options, count, keys, names, values))
+    {
+        free(values);
+        return NULL;
+    }
+    for (int k=0; k<count; k++)
+        if (values[k] >= 0 && (values[k] < ranges[k][0] || values[k] > ranges[k][1]))
+        {
+            printf("%s: invalid parameter %s=%d, the range is %d-%d\n", codec, keys[k], values[k], ranges[k][0], ranges[k][1]);
+            free(values);
+            return NULL;
+        }
+    return values;
+}
+
+void lzbench_options_deinit(char* workmem)
+{
+    free(workmem);
+}
+
+
 #ifndef BENCH_REMOVE_BLOSCLZ
 #include "blosclz/blosclz.h"
 
@@ -88,6 +153,222 @@ int64_t lzbench_brotli_decompress(char *inbuf, size_t insize, char *outbuf, size
     return BrotliDecoderDecompress(insize, (const uint8_t*)inbuf, &actual_osize, (uint8_t*)outbuf) == BROTLI_DECODER_RESULT_ERROR ? 0 : actual_osize;
 }
 
+/* brotli_adv: the level with the encoder parameters of the key=value list of -e, the decoder allows large windows */
+#define BROTLI_ADV_KEYS 4
+static const char* brotli_adv_keys[BROTLI_ADV_KEYS] = { "mode", "lgwin", "lgblock", "large_window" };
+static const char* brotli_adv_names[BROTLI_ADV_KEYS] = { "generic|text|font", NULL, NULL, NULL };
+static const BrotliEncoderParameter brotli_adv_params[BROTLI_ADV_KEYS] = { BROTLI_PARAM_MODE, BROTLI_PARAM_LGWIN, BROTLI_PARAM_LGBLOCK, BROTLI_PARAM_LARGE_WINDOW };
+static const int brotli_adv_ranges[BROTLI_ADV_KEYS][2] = { { 0, 2 }, { BROTLI_MIN_WINDOW_BITS, BROTLI_LARGE_MAX_WINDOW_BITS },
+    { BROTLI_MIN_INPUT_BLOCK_BITS, BROTLI_MAX_INPUT_BLOCK_BITS }, { 0, 1 } };
+
+char* lzbench_brotli_adv_init(size_t, size_t level, size_t options)
+{
+    int* values = lzbench_options_init("brotli_adv", options, BROTLI_ADV_KEYS, brotli_adv_keys, brotli_adv_names, brotli_adv_ranges);
+    if (values && values[1] > BROTLI_MAX_WINDOW_BITS && values[3] <= 0)
+    {
+        printf("brotli_adv: lgwin=%d needs large_window=1 (lgwin is at most %d otherwise)\n", values[1], BROTLI_MAX_WINDOW_BITS);
+        free(values);
+        return NULL;
+    }
+    return (char*)values;
+}
+
+int64_t lzbench_brotli_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    const int* values = (const int*)workmem;
+    BrotliEncoderState* enc = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+    if (!values || !enc) { if (enc) BrotliEncoderDestroyInstance(enc); return 0; }
+
+    int ok = BrotliEncoderSetParameter(enc, BROTLI_PARAM_QUALITY, level);
+    for (int k=0; k<BROTLI_ADV_KEYS; k++)
+        if (values[k] >= 0) ok &= BrotliEncoderSetParameter(enc, brotli_adv_params[k], values[k]);
+    BrotliEncoderSetParameter(enc, BROTLI_PARAM_SIZE_HINT, insize);
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    ok = ok && BrotliEncoderCompressStream(enc, BROTLI_OPERATION_FINISH, &avail_in, &next_in, &avail_out, &next_out, NULL) && BrotliEncoderIsFinished(enc);
+    BrotliEncoderDestroyInstance(enc);
+    return ok ? outsize - avail_out : 0;
+}
+
+int64_t lzbench_brotli_adv_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    const int* values = (const int*)workmem;
+    BrotliDecoderState* dec = BrotliDecoderCreateInstance(NULL, NULL, NULL);
+    if (!values || !dec) { if (dec) BrotliDecoderDestroyInstance(dec); return 0; }
+    if (values[3] > 0) BrotliDecoderSetParameter(dec, BROTLI_DECODER_PARAM_LARGE_WINDOW, 1);
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    BrotliDecoderResult res = BrotliDecoderDecompressStream(dec, &avail_in, &next_in, &avail_out, &next_out, NULL);
+    BrotliDecoderDestroyInstance(dec);
+    return (res == BROTLI_DECODER_RESULT_SUCCESS) ? outsize - avail_out : 0;
+}
+
+/* --linked: one stream flushed after each block, lzbench_brotli_linked_reset() starts a new stream at each pass */
+typedef struct {
+    BrotliEncoderState* enc;
+    BrotliDecoderState* dec;
+    size_t level, windowLog;
+} brotli_linked_t;
+
+char* lzbench_brotli_linked_init(size_t, size_t level, size_t windowLog)
+{
+    brotli_linked_t* s = (brotli_linked_t*)calloc(1, sizeof(brotli_linked_t));
+    if (!s) return NULL;
+    s->level = level;
+    s->windowLog = windowLog ? windowLog : BROTLI_DEFAULT_WINDOW;
+    return (char*)s;
+}
+
+void lzbench_brotli_linked_deinit(char* workmem)
+{
+    brotli_linked_t* s = (brotli_linked_t*)workmem;
+    if (!s) return;
+    if (s->enc) BrotliEncoderDestroyInstance(s->enc);
+    if (s->dec) BrotliDecoderDestroyInstance(s->dec);
+    free(s);
+}
+
+void lzbench_brotli_linked_reset(char* workmem)
+{
+    brotli_linked_t* s = (brotli_linked_t*)workmem;
+    if (!s) return;
+    if (s->enc) BrotliEncoderDestroyInstance(s->enc);
+    if (s->dec) BrotliDecoderDestroyInstance(s->dec);
+    s->enc = NULL;
+    s->dec = NULL;
+}
+
+int64_t lzbench_brotli_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    brotli_linked_t* s = (brotli_linked_t*)workmem;
+    if (!s) return 0;
+    if (!s->enc)
+    {
+        s->enc = BrotliEncoderCreateInstance(NULL, NULL, NULL);
+        if (!s->enc) return 0;
+        BrotliEncoderSetParameter(s->enc, BROTLI_PARAM_QUALITY, s->level);
+        BrotliEncoderSetParameter(s->enc, BROTLI_PARAM_LGWIN, s->windowLog);
+    }
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    do {
+        if (!BrotliEncoderCompressStream(s->enc, BROTLI_OPERATION_FLUSH, &avail_in, &next_in, &avail_out, &next_out, NULL)) return 0;
+    } while ((avail_in || BrotliEncoderHasMoreOutput(s->enc)) && avail_out);
+    if (avail_in || BrotliEncoderHasMoreOutput(s->enc)) return 0;
+    return outsize - avail_out;
+}
+
+int64_t lzbench_brotli_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    brotli_linked_t* s = (brotli_linked_t*)workmem;
+    if (!s) return 0;
+    if (!s->dec)
+    {
+        s->dec = BrotliDecoderCreateInstance(NULL, NULL, NULL);
+        if (!s->dec) return 0;
+    }
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    if (BrotliDecoderDecompressStream(s->dec, &avail_in, &next_in, &avail_out, &next_out, NULL) == BROTLI_DECODER_RESULT_ERROR) return 0;
+    return outsize - avail_out;
+}
+
+/* --streams: brotli can't reset a finished state, so the encoder and the decoder of a stream are created for each
+   block from the memory of the stream, freed blocks are kept and handed out again to the next state of the stream */
+#define BROTLI_STREAM_POOL 64
+#define BROTLI_STREAM_HEADER 16   // the size of a block in front of it, keeps the alignment of malloc
+typedef struct {
+    void* free_blocks[BROTLI_STREAM_POOL];
+    int free_count;
+    size_t level, windowLog;
+} brotli_stream_t;
+
+static void* brotli_stream_alloc(void* opaque, size_t size)
+{
+    brotli_stream_t* s = (brotli_stream_t*)opaque;
+    int best = -1;
+    for (int i=0; i<s->free_count; i++)
+    {
+        size_t block_size = *(size_t*)s->free_blocks[i];
+        if (block_size >= size && (best < 0 || block_size < *(size_t*)s->free_blocks[best])) best = i;
+    }
+    if (best >= 0)
+    {
+        char* block = (char*)s->free_blocks[best];
+        s->free_blocks[best] = s->free_blocks[--s->free_count];
+        return block + BROTLI_STREAM_HEADER;
+    }
+    char* block = (char*)malloc(size + BROTLI_STREAM_HEADER);
+    if (!block) return NULL;
+    *(size_t*)block = size;
+    return block + BROTLI_STREAM_HEADER;
+}
+
+static void brotli_stream_free(void* opaque, void* address)
+{
+    brotli_stream_t* s = (brotli_stream_t*)opaque;
+    if (!address) return;
+    char* block = (char*)address - BROTLI_STREAM_HEADER;
+    if (s->free_count < BROTLI_STREAM_POOL) s->free_blocks[s->free_count++] = block;
+    else free(block);
+}
+
+char* lzbench_brotli_stream_init(size_t, size_t level, size_t windowLog)
+{
+    brotli_stream_t* s = (brotli_stream_t*)calloc(1, sizeof(brotli_stream_t));
+    if (!s) return NULL;
+    s->level = level;
+    s->windowLog = windowLog ? windowLog : BROTLI_DEFAULT_WINDOW;
+    return (char*)s;
+}
+
+void lzbench_brotli_stream_deinit(char* workmem)
+{
+    brotli_stream_t* s = (brotli_stream_t*)workmem;
+    if (!s) return;
+    for (int i=0; i<s->free_count; i++) free(s->free_blocks[i]);
+    free(s);
+}
+
+int64_t lzbench_brotli_stream_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    brotli_stream_t* s = (brotli_stream_t*)workmem;
+    BrotliEncoderState* enc = s ? BrotliEncoderCreateInstance(brotli_stream_alloc, brotli_stream_free, s) : NULL;
+    if (!enc) return 0;
+    BrotliEncoderSetParameter(enc, BROTLI_PARAM_QUALITY, s->level);
+    BrotliEncoderSetParameter(enc, BROTLI_PARAM_LGWIN, s->windowLog);
+    BrotliEncoderSetParameter(enc, BROTLI_PARAM_SIZE_HINT, insize);
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    int ok = BrotliEncoderCompressStream(enc, BROTLI_OPERATION_FINISH, &avail_in, &next_in, &avail_out, &next_out, NULL) && BrotliEncoderIsFinished(enc);
+    BrotliEncoderDestroyInstance(enc);
+    return ok ? outsize - avail_out : 0;
+}
+
+int64_t lzbench_brotli_stream_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    brotli_stream_t* s = (brotli_stream_t*)workmem;
+    BrotliDecoderState* dec = s ? BrotliDecoderCreateInstance(brotli_stream_alloc, brotli_stream_free, s) : NULL;
+    if (!dec) return 0;
+
+    const uint8_t* next_in = (const uint8_t*)inbuf;
+    uint8_t* next_out = (uint8_t*)outbuf;
+    size_t avail_in = insize, avail_out = outsize;
+    BrotliDecoderResult res = BrotliDecoderDecompressStream(dec, &avail_in, &next_in, &avail_out, &next_out, NULL);
+    BrotliDecoderDestroyInstance(dec);
+    return (res == BROTLI_DECODER_RESULT_SUCCESS) ? outsize - avail_out : 0;
+}
+
 #endif // BENCH_REMOVE_BROTLI
 
 
@@ -285,6 +566,28 @@ int64_t lzbench_libdeflate_decompress(char *inbuf, size_t insize, char *outbuf,
     }
     return res;
 }
+int64_t lzbench_libdeflate_gzip_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*)
+{
+    struct libdeflate_compressor *compressor = libdeflate_alloc_compressor(level);
+    if (!compressor)
+        return 0;
+    int64_t res = libdeflate_gzip_compress(compressor, inbuf, insize, outbuf, outsize);
+    libdeflate_free_compressor(compressor);
+    return res;
+}
+int64_t lzbench_libdeflate_gzip_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*)
+{
+    struct libdeflate_decompressor *decompressor = libdeflate_alloc_decompressor();
+    if (!decompressor)
+        return 0;
+    size_t res = 0;
+    // checks the CRC32 from the gzip trailer
+    if (libdeflate_gzip_decompress(decompressor, inbuf, insize, outbuf, outsize, &res) != LIBDEFLATE_SUCCESS) {
+        res = 0;
+    }
+    libdeflate_free_decompressor(decompressor);
+    return res;
+}
 #endif
 
 
@@ -311,8 +614,9 @@ int64_t lzbench_lizard_decompress(char *inbuf, size_t insize, char *outbuf, size
 #include "lz4/lz4.h"
 #include "lz4/lz4hc.h"
 
-int64_t lzbench_lz4_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*)
+int64_t lzbench_lz4_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
 {
+	if (workmem) return LZ4_compress_fast_extState(workmem, inbuf, outbuf, insize, outsize, 1);  // a caller's LZ4_stream_t
 	return LZ4_compress_default(inbuf, outbuf, insize, outsize);
 }
 
@@ -331,6 +635,113 @@ int64_t lzbench_lz4_decompress(char *inbuf, size_t insize, char *outbuf, size_t
 	return LZ4_decompress_safe(inbuf, outbuf, insize, outsize);
 }
 
+/* --linked: the previous blocks stay in place in the contiguous input and output and are the history of the next block,
+   lzbench_lz4_linked_reset() starts a new stream at each pass */
+typedef struct {
+    LZ4_stream_t stream;
+    LZ4_streamHC_t streamHC;
+    LZ4_streamDecode_t decode;
+    int level;
+} lz4_linked_t;
+
+char* lzbench_lz4_linked_init(size_t, size_t level, size_t)
+{
+    lz4_linked_t* s = (lz4_linked_t*)malloc(sizeof(lz4_linked_t));
+    if (!s) return NULL;
+    LZ4_initStream(&s->stream, sizeof(s->stream));
+    LZ4_initStreamHC(&s->streamHC, sizeof(s->streamHC));
+    LZ4_setStreamDecode(&s->decode, NULL, 0);
+    s->level = level;
+    return (char*)s;
+}
+
+void lzbench_lz4_linked_deinit(char* workmem)
+{
+    free(workmem);
+}
+
+void lzbench_lz4_linked_reset(char* workmem)
+{
+    lz4_linked_t* s = (lz4_linked_t*)workmem;
+    if (!s) return;
+    LZ4_resetStream_fast(&s->stream);
+    LZ4_resetStreamHC_fast(&s->streamHC, s->level);
+    LZ4_setStreamDecode(&s->decode, NULL, 0);
+}
+
+int64_t lzbench_lz4_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    lz4_linked_t* s = (lz4_linked_t*)workmem;
+    if (!s) return 0;
+    return LZ4_compress_fast_continue(&s->stream, inbuf, outbuf, insize, outsize, 1);
+}
+
+int64_t lzbench_lz4fast_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    lz4_linked_t* s = (lz4_linked_t*)workmem;
+    if (!s) return 0;
+    return LZ4_compress_fast_continue(&s->stream, inbuf, outbuf, insize, outsize, level);
+}
+
+int64_t lzbench_lz4hc_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    lz4_linked_t* s = (lz4_linked_t*)workmem;
+    if (!s) return 0;
+    return LZ4_compress_HC_continue(&s->streamHC, inbuf, outbuf, insize, outsize);
+}
+
+int64_t lzbench_lz4_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    lz4_linked_t* s = (lz4_linked_t*)workmem;
+    if (!s) return 0;
+    return LZ4_decompress_safe_continue(&s->decode, inbuf, outbuf, insize, outsize);
+}
+
+#include "lz4/lz4frame.h"
+
+char* lzbench_lz4frame_init(size_t, size_t, size_t)
+{
+    LZ4F_dctx* dctx = NULL;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) return NULL;
+    return (char*)dctx;
+}
+
+void lzbench_lz4frame_deinit(char* workmem)
+{
+    if (workmem) LZ4F_freeDecompressionContext((LZ4F_dctx*)workmem);
+}
+
+/* frame with a content checksum, levels 0-2 use LZ4_compress, 3+ use lz4hc */
+int64_t lzbench_lz4frame_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*)
+{
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.compressionLevel = level;
+    prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+    prefs.frameInfo.blockMode = LZ4F_blockIndependent; // like lz4 blocks, without copying a dictionary between blocks
+    // the decoder writes directly to the output only while a whole block fits there
+    prefs.frameInfo.blockSizeID = (insize >= (4<<20)) ? LZ4F_max4MB : (insize >= (1<<20)) ? LZ4F_max1MB : (insize >= (256<<10)) ? LZ4F_max256KB : LZ4F_max64KB;
+    prefs.frameInfo.contentSize = insize;
+
+    size_t res = LZ4F_compressFrame(outbuf, outsize, inbuf, insize, &prefs);
+    if (LZ4F_isError(res)) return 0;
+    return res;
+}
+
+int64_t lzbench_lz4frame_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    LZ4F_dctx* dctx = (LZ4F_dctx*)workmem;
+    if (!dctx) return 0;
+
+    size_t res = LZ4F_decompress(dctx, outbuf, &outsize, inbuf, &insize, NULL);
+    if (res != 0) // error or incomplete frame
+    {
+        LZ4F_resetDecompressionContext(dctx);
+        return 0;
+    }
+    return outsize;
+}
+
 #endif
 
 
@@ -662,6 +1073,42 @@ int64_t lzbench_lzma_decompress(char *inbuf, size_t insize, char *outbuf, size_t
     return out_len;
 }
 
+/* lzma_adv: CLzmaEncProps of the level overridden by the key=value list of -e, dict is log2 of the dictionary size */
+#define LZMA_ADV_KEYS 8
+static const char* lzma_adv_keys[LZMA_ADV_KEYS] = { "lc", "lp", "pb", "dict", "fb", "mc", "bt", "hb" };
+static const int lzma_adv_ranges[LZMA_ADV_KEYS][2] = { { 0, 8 }, { 0, 4 }, { 0, 4 }, { 12, 30 }, { 5, 273 }, { 1, 1 << 30 }, { 0, 1 }, { 2, 4 } };
+
+int64_t lzbench_lzma_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    const int* values = (const int*)workmem;
+    CLzmaEncProps props;
+    size_t headerSize = LZMA_PROPS_SIZE;
+    SizeT out_len = outsize - LZMA_PROPS_SIZE;
+    if (!values) return 0;
+
+    LzmaEncProps_Init(&props);
+    props.level = level;
+    if (values[0] >= 0) props.lc = values[0];
+    if (values[1] >= 0) props.lp = values[1];
+    if (values[2] >= 0) props.pb = values[2];
+    if (values[3] >= 0) props.dictSize = (UInt32)1 << values[3];
+    if (values[4] >= 0) props.fb = values[4];
+    if (values[5] >= 0) props.mc = values[5];
+    if (values[6] >= 0) props.btMode = values[6];
+    if (values[7] >= 0) props.numHashBytes = values[7];
+    if (values[3] < 0) props.reduceSize = insize;  // a smaller dictionary of the level for small inputs, not of dict=
+    LzmaEncProps_Normalize(&props);
+
+    int res = LzmaEncode((uint8_t*)outbuf+LZMA_PROPS_SIZE, &out_len, (uint8_t*)inbuf, insize, &props, (uint8_t*)outbuf, &headerSize, 0, NULL, &g_Alloc, &g_Alloc);
+    if (res != SZ_OK) return 0;
+    return LZMA_PROPS_SIZE + out_len;
+}
+
+char* lzbench_lzma_adv_init(size_t, size_t level, size_t options)
+{
+    return (char*)lzbench_options_init("lzma_adv", options, LZMA_ADV_KEYS, lzma_adv_keys, NULL, lzma_adv_ranges);
+}
+
 #endif
 
 
@@ -1094,6 +1541,15 @@ int64_t lzbench_lzsse4_decompress(char *inbuf, size_t insize, char *outbuf, size
     return LZSSE4_Decompress(inbuf, insize, outbuf, outsize);
 }
 
+int64_t lzbench_lzsse4_avx2_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*)
+{
+#if defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+        return LZSSE4_Decompress_AVX2(inbuf, insize, outbuf, outsize);
+#endif
+    return 0;
+}
+
 char* lzbench_lzsse4fast_init(size_t, size_t, size_t)
 {
     return (char*) LZSSE4_MakeFastParseState();
@@ -1138,6 +1594,15 @@ int64_t lzbench_lzsse8_decompress(char *inbuf, size_t insize, char *outbuf, size
     return LZSSE8_Decompress(inbuf, insize, outbuf, outsize);
 }
 
+int64_t lzbench_lzsse8_avx2_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*)
+{
+#if defined(__GNUC__)
+    if (__builtin_cpu_supports("avx2"))
+        return LZSSE8_Decompress_AVX2(inbuf, insize, outbuf, outsize);
+#endif
+    return 0;
+}
+
 char* lzbench_lzsse8fast_init(size_t, size_t, size_t)
 {
     return (char*) LZSSE8_MakeFastParseState();
@@ -1444,6 +1909,29 @@ int64_t lzbench_xz_decompress(char *inbuf, size_t insize, char *outbuf, size_t o
     return xz_alone_decompress(inbuf, insize, outbuf, outsize, 0, 0, 0);
 }
 
+/* xz_adv: the preset with the lzma_options_lzma of the key=value list of -e, in the order of xz_alone_options_t */
+static const char* xz_adv_keys[XZ_ALONE_OPTIONS] = { "dict", "lc", "lp", "pb", "mode", "nice", "mf", "depth" };
+static const char* xz_adv_names[XZ_ALONE_OPTIONS] = { NULL, NULL, NULL, NULL, "|fast|normal", NULL, "hc3|hc4|bt2|bt3|bt4", NULL };
+static const int xz_adv_ranges[XZ_ALONE_OPTIONS][2] = { { 12, 30 }, { 0, 4 }, { 0, 4 }, { 0, 4 }, { 1, 2 }, { 2, 273 }, { 0, 4 }, { 0, 1 << 30 } };
+
+int64_t lzbench_xz_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    if (!workmem) return 0;
+    return xz_alone_compress(inbuf, insize, outbuf, outsize, level, (size_t)workmem, 0);
+}
+
+char* lzbench_xz_adv_init(size_t, size_t level, size_t options)
+{
+    int* values = lzbench_options_init("xz_adv", options, XZ_ALONE_OPTIONS, xz_adv_keys, xz_adv_names, xz_adv_ranges);
+    if (values && !xz_alone_options_valid(level, (size_t)values))
+    {
+        printf("xz_adv: invalid parameters %s at level %d (lc + lp over 4 or nice below the bytes of mf)\n", (const char*)options, (int)level);
+        free(values);
+        return NULL;
+    }
+    return (char*)values;
+}
+
 #endif
 
 
@@ -1519,6 +2007,114 @@ int64_t lzbench_zlib_decompress(char *inbuf, size_t insize, char *outbuf, size_t
 	return outsize;
 }
 
+/* --linked: one deflate stream with a Z_SYNC_FLUSH after each block, lzbench_zlib_linked_reset() starts a new stream at each pass */
+typedef struct {
+    z_stream comp;
+    z_stream decomp;
+} zlib_linked_t;
+
+char* lzbench_zlib_linked_init(size_t, size_t level, size_t)
+{
+    zlib_linked_t* s = (zlib_linked_t*)calloc(1, sizeof(zlib_linked_t));
+    if (!s) return NULL;
+    if (deflateInit(&s->comp, level) != Z_OK) { free(s); return NULL; }
+    if (inflateInit(&s->decomp) != Z_OK) { deflateEnd(&s->comp); free(s); return NULL; }
+    return (char*)s;
+}
+
+void lzbench_zlib_linked_deinit(char* workmem)
+{
+    zlib_linked_t* s = (zlib_linked_t*)workmem;
+    if (!s) return;
+    deflateEnd(&s->comp);
+    inflateEnd(&s->decomp);
+    free(s);
+}
+
+void lzbench_zlib_linked_reset(char* workmem)
+{
+    zlib_linked_t* s = (zlib_linked_t*)workmem;
+    if (!s) return;
+    deflateReset(&s->comp);
+    inflateReset(&s->decomp);
+}
+
+int64_t lzbench_zlib_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zlib_linked_t* s = (zlib_linked_t*)workmem;
+    if (!s) return 0;
+    s->comp.next_in = (Bytef*)inbuf;
+    s->comp.avail_in = insize;
+    s->comp.next_out = (Bytef*)outbuf;
+    s->comp.avail_out = outsize;
+    int err = deflate(&s->comp, Z_SYNC_FLUSH);
+    if (err != Z_OK || s->comp.avail_in || !s->comp.avail_out) return 0; // a full output may hold back flushed bytes
+    return outsize - s->comp.avail_out;
+}
+
+int64_t lzbench_zlib_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zlib_linked_t* s = (zlib_linked_t*)workmem;
+    if (!s) return 0;
+    s->decomp.next_in = (Bytef*)inbuf;
+    s->decomp.avail_in = insize;
+    s->decomp.next_out = (Bytef*)outbuf;
+    s->decomp.avail_out = outsize;
+    int err = inflate(&s->decomp, Z_SYNC_FLUSH);
+    if (err != Z_OK && err != Z_BUF_ERROR) return 0;
+    return outsize - s->decomp.avail_out;
+}
+
+/* --streams: a deflate and an inflate state per stream, reset for each block instead of allocated by compress2 and uncompress */
+typedef struct {
+    z_stream comp;
+    z_stream decomp;
+} zlib_stream_t;
+
+char* lzbench_zlib_stream_init(size_t, size_t level, size_t)
+{
+    zlib_stream_t* s = (zlib_stream_t*)calloc(1, sizeof(zlib_stream_t));
+    if (!s) return NULL;
+    if (deflateInit(&s->comp, level) != Z_OK) { free(s); return NULL; }
+    if (inflateInit(&s->decomp) != Z_OK) { deflateEnd(&s->comp); free(s); return NULL; }
+    return (char*)s;
+}
+
+void lzbench_zlib_stream_deinit(char* workmem)
+{
+    zlib_stream_t* s = (zlib_stream_t*)workmem;
+    if (!s) return;
+    deflateEnd(&s->comp);
+    inflateEnd(&s->decomp);
+    free(s);
+}
+
+int64_t lzbench_zlib_stream_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zlib_stream_t* s = (zlib_stream_t*)workmem;
+    if (!s || deflateReset(&s->comp) != Z_OK) return 0;
+
+    s->comp.next_in = (Bytef*)inbuf;
+    s->comp.avail_in = insize;
+    s->comp.next_out = (Bytef*)outbuf;
+    s->comp.avail_out = outsize;
+    if (deflate(&s->comp, Z_FINISH) != Z_STREAM_END) return 0;
+    return outsize - s->comp.avail_out;
+}
+
+int64_t lzbench_zlib_stream_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zlib_stream_t* s = (zlib_stream_t*)workmem;
+    if (!s || inflateReset(&s->decomp) != Z_OK) return 0;
+
+    s->decomp.next_in = (Bytef*)inbuf;
+    s->decomp.avail_in = insize;
+    s->decomp.next_out = (Bytef*)outbuf;
+    s->decomp.avail_out = outsize;
+    if (inflate(&s->decomp, Z_FINISH) != Z_STREAM_END) return 0;
+    return outsize - s->decomp.avail_out;
+}
+
 #endif
 
 
@@ -1712,7 +2308,7 @@ void lzbench_zstd_deinit(char* workmem)
     free(workmem);
 }
 
-int64_t lzbench_zstd_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t windowLog, char* workmem)
+static int64_t zstd_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t windowLog, char* workmem, int checksumFlag)
 {
     size_t res;
 
@@ -1723,6 +2319,7 @@ int64_t lzbench_zstd_compress(char *inbuf, size_t insize, char *outbuf, size_t o
     zstd_params->zparams = ZSTD_getParams(level, insize, 0);
     ZSTD_CCtx_setParameter(zstd_params->cctx, ZSTD_c_compressionLevel, level);
     zstd_params->zparams.fParams.contentSizeFlag = 1;
+    zstd_params->zparams.fParams.checksumFlag = checksumFlag;
 
     if (windowLog && zstd_params->zparams.cParams.windowLog > windowLog) {
         zstd_params->zparams.cParams.windowLog = windowLog;
@@ -1739,6 +2336,17 @@ int64_t lzbench_zstd_compress(char *inbuf, size_t insize, char *outbuf, size_t o
     return res;
 }
 
+int64_t lzbench_zstd_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t windowLog, char* workmem)
+{
+    return zstd_compress(inbuf, insize, outbuf, outsize, level, windowLog, workmem, 0);
+}
+
+/* frame with a XXH64 content checksum, ZSTD_decompressDCtx verifies it */
+int64_t lzbench_zstd_chk_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t windowLog, char* workmem)
+{
+    return zstd_compress(inbuf, insize, outbuf, outsize, level, windowLog, workmem, 1);
+}
+
 int64_t lzbench_zstd_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
 {
     zstd_params_s* zstd_params = (zstd_params_s*) workmem;
@@ -1762,6 +2370,127 @@ int64_t lzbench_zstd_LDM_compress(char *inbuf, size_t insize, char *outbuf, size
     ZSTD_CCtx_setParameter(zstd_params->cctx, ZSTD_c_enableLongDistanceMatching, 1);
     return lzbench_zstd_compress(inbuf, insize, outbuf, outsize, level, windowLog, (char*) zstd_params);
 }
+
+/* zstd_adv: the level with ZSTD_compressionParameters overridden by the key=value list of -e that param2 points to */
+#define ZSTD_ADV_KEYS 9
+static const char* zstd_adv_keys[ZSTD_ADV_KEYS] = { "wlog", "clog", "hlog", "slog", "mml", "tlen", "strat", "ldm", "chk" };
+static const char* zstd_adv_names[ZSTD_ADV_KEYS] = { NULL, NULL, NULL, NULL, NULL, NULL, "|fast|dfast|greedy|lazy|lazy2|btlazy2|btopt|btultra|btultra2", NULL, NULL };
+static const ZSTD_cParameter zstd_adv_params[ZSTD_ADV_KEYS] = { ZSTD_c_windowLog, ZSTD_c_chainLog, ZSTD_c_hashLog, ZSTD_c_searchLog,
+    ZSTD_c_minMatch, ZSTD_c_targetLength, ZSTD_c_strategy, ZSTD_c_enableLongDistanceMatching, ZSTD_c_checksumFlag };
+
+/* quiet for the parameter sets of --zstd-search, which skips those zstd rejects */
+static int zstd_adv_set(ZSTD_CCtx* cctx, const char* options, int quiet)
+{
+    int values[ZSTD_ADV_KEYS];
+
+    for (int k=0; k<ZSTD_ADV_KEYS; k++) values[k] = -1;
+    if (!lzbench_parse_options("zstd_adv", options, ZSTD_ADV_KEYS, zstd_adv_keys, zstd_adv_names, values)) return 0;
+    for (int k=0; k<ZSTD_ADV_KEYS; k++)
+        if (values[k] >= 0 && ZSTD_isError(ZSTD_CCtx_setParameter(cctx, zstd_adv_params[k], values[k])))
+        {
+            if (!quiet) printf("zstd_adv: invalid parameter %s=%d\n", zstd_adv_keys[k], values[k]);
+            return 0;
+        }
+    return 1;
+}
+
+static char* zstd_adv_init(size_t insize, size_t level, size_t options, int quiet)
+{
+    zstd_params_s* zstd_params = (zstd_params_s*) lzbench_zstd_init(insize, level, 0);
+    if (!zstd_params) return NULL;
+    if (!zstd_params->cctx || !zstd_params->dctx ||
+        ZSTD_isError(ZSTD_CCtx_setParameter(zstd_params->cctx, ZSTD_c_compressionLevel, level)) ||
+        (options && !zstd_adv_set(zstd_params->cctx, (const char*)options, quiet)))
+    {
+        lzbench_zstd_deinit((char*) zstd_params);
+        return NULL;
+    }
+    ZSTD_DCtx_setParameter(zstd_params->dctx, ZSTD_d_windowLogMax, ZSTD_WINDOWLOG_MAX); // wlog above the default limit of 27
+    return (char*) zstd_params;
+}
+
+char* lzbench_zstd_adv_init(size_t insize, size_t level, size_t options)
+{
+    return zstd_adv_init(insize, level, options, 0);
+}
+
+char* lzbench_zstd_adv_search_init(size_t insize, size_t level, size_t options)
+{
+    return zstd_adv_init(insize, level, options, 1);
+}
+
+int64_t lzbench_zstd_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zstd_params_s* zstd_params = (zstd_params_s*) workmem;
+    if (!zstd_params) return 0;
+
+    size_t res = ZSTD_compress2(zstd_params->cctx, outbuf, outsize, inbuf, insize);
+    if (ZSTD_isError(res)) return 0;
+    return res;
+}
+
+/* --linked: one frame with a ZSTD_e_flush after each block, lzbench_zstd_linked_reset() starts a new frame at each pass */
+typedef struct {
+    ZSTD_CCtx* cctx;
+    ZSTD_DCtx* dctx;
+} zstd_linked_t;
+
+char* lzbench_zstd_linked_init(size_t, size_t level, size_t windowLog)
+{
+    zstd_linked_t* s = (zstd_linked_t*)calloc(1, sizeof(zstd_linked_t));
+    if (!s) return NULL;
+    s->cctx = ZSTD_createCCtx();
+    s->dctx = ZSTD_createDCtx();
+    if (s->cctx)
+    {
+        ZSTD_CCtx_setParameter(s->cctx, ZSTD_c_compressionLevel, level);
+        if (windowLog) ZSTD_CCtx_setParameter(s->cctx, ZSTD_c_windowLog, windowLog);
+    }
+    return (char*)s;
+}
+
+void lzbench_zstd_linked_deinit(char* workmem)
+{
+    zstd_linked_t* s = (zstd_linked_t*)workmem;
+    if (!s) return;
+    if (s->cctx) ZSTD_freeCCtx(s->cctx);
+    if (s->dctx) ZSTD_freeDCtx(s->dctx);
+    free(s);
+}
+
+void lzbench_zstd_linked_reset(char* workmem)
+{
+    zstd_linked_t* s = (zstd_linked_t*)workmem;
+    if (!s) return;
+    if (s->cctx) ZSTD_CCtx_reset(s->cctx, ZSTD_reset_session_only);
+    if (s->dctx) ZSTD_DCtx_reset(s->dctx, ZSTD_reset_session_only);
+}
+
+int64_t lzbench_zstd_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zstd_linked_t* s = (zstd_linked_t*)workmem;
+    if (!s || !s->cctx) return 0;
+    ZSTD_inBuffer in = { inbuf, insize, 0 };
+    ZSTD_outBuffer out = { outbuf, outsize, 0 };
+    size_t res;
+    do {
+        res = ZSTD_compressStream2(s->cctx, &out, &in, ZSTD_e_flush);
+        if (ZSTD_isError(res)) return 0;
+    } while (res && out.pos < out.size);
+    if (res) return 0;
+    return out.pos;
+}
+
+int64_t lzbench_zstd_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char* workmem)
+{
+    zstd_linked_t* s = (zstd_linked_t*)workmem;
+    if (!s || !s->dctx) return 0;
+    ZSTD_inBuffer in = { inbuf, insize, 0 };
+    ZSTD_outBuffer out = { outbuf, outsize, 0 };
+    while (in.pos < in.size && out.pos < out.size)
+        if (ZSTD_isError(ZSTD_decompressStream(s->dctx, &out, &in))) return 0;
+    return out.pos;
+}
 #endif
 
 
@@ -1779,3 +2508,26 @@ int64_t lzbench_nakamichi_decompress(char *inbuf, size_t insize, char *outbuf, s
 }
 
 #endif
+
+
+
+/* the wrappers of the codecs that are built for each instruction set (see isa.h), each
+   isa/<name>/isa-codecs.o has a copy of this table with the same order */
+const isa_func_t lzbench_isa_funcs[] =
+{
+    (isa_func_t)lzbench_lz4_compress, (isa_func_t)lzbench_lz4fast_compress, (isa_func_t)lzbench_lz4hc_compress, (isa_func_t)lzbench_lz4_decompress,
+    (isa_func_t)lzbench_lz4frame_compress, (isa_func_t)lzbench_lz4frame_decompress, (isa_func_t)lzbench_lz4frame_init, (isa_func_t)lzbench_lz4frame_deinit,
+    (isa_func_t)lzbench_lizard_compress, (isa_func_t)lzbench_lizard_decompress,
+    (isa_func_t)lzbench_zstd_compress, (isa_func_t)lzbench_zstd_chk_compress, (isa_func_t)lzbench_zstd_LDM_compress, (isa_func_t)lzbench_zstd_decompress, (isa_func_t)lzbench_zstd_init, (isa_func_t)lzbench_zstd_LDM_init, (isa_func_t)lzbench_zstd_deinit,
+    (isa_func_t)lzbench_zstd_adv_compress, (isa_func_t)lzbench_zstd_adv_init,
+    (isa_func_t)lzbench_libdeflate_compress, (isa_func_t)lzbench_libdeflate_decompress, (isa_func_t)lzbench_libdeflate_gzip_compress, (isa_func_t)lzbench_libdeflate_gzip_decompress,
+    (isa_func_t)lzbench_snappy_compress, (isa_func_t)lzbench_snappy_decompress,
+    (isa_func_t)lzbench_brotli_compress, (isa_func_t)lzbench_brotli_decompress,
+    (isa_func_t)lzbench_brotli_adv_compress, (isa_func_t)lzbench_brotli_adv_decompress, (isa_func_t)lzbench_brotli_adv_init,
+    (isa_func_t)lzbench_brotli_stream_compress, (isa_func_t)lzbench_brotli_stream_decompress, (isa_func_t)lzbench_brotli_stream_init, (isa_func_t)lzbench_brotli_stream_deinit,
+    (isa_func_t)lzbench_lzsse2_compress, (isa_func_t)lzbench_lzsse2_decompress, (isa_func_t)lzbench_lzsse2_init, (isa_func_t)lzbench_lzsse2_deinit,
+    (isa_func_t)lzbench_lzsse4_compress, (isa_func_t)lzbench_lzsse4fast_compress, (isa_func_t)lzbench_lzsse4_decompress, (isa_func_t)lzbench_lzsse4_init, (isa_func_t)lzbench_lzsse4fast_init, (isa_func_t)lzbench_lzsse4_deinit, (isa_func_t)lzbench_lzsse4fast_deinit,
+    (isa_func_t)lzbench_lzsse8_compress, (isa_func_t)lzbench_lzsse8fast_compress, (isa_func_t)lzbench_lzsse8_decompress, (isa_func_t)lzbench_lzsse8_init, (isa_func_t)lzbench_lzsse8fast_init, (isa_func_t)lzbench_lzsse8_deinit, (isa_func_t)lzbench_lzsse8fast_deinit,
+};
+
+const int lzbench_isa_funcs_count = sizeof(lzbench_isa_funcs) / sizeof(lzbench_isa_funcs[0]);
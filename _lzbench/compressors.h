@@ -6,6 +6,7 @@
 
 int64_t lzbench_memcpy(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t , size_t, char* );
 int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t , size_t, char* );
+void lzbench_options_deinit(char* workmem);  // of the codecs with key=value parameters kept in workmem
 
 
 
@@ -34,9 +35,33 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 #ifndef BENCH_REMOVE_BROTLI
 	int64_t lzbench_brotli_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 	int64_t lzbench_brotli_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_brotli_adv_init(size_t insize, size_t level, size_t);
+	int64_t lzbench_brotli_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_brotli_adv_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_brotli_linked_init(size_t insize, size_t level, size_t);
+	void lzbench_brotli_linked_deinit(char* workmem);
+	void lzbench_brotli_linked_reset(char* workmem);
+	int64_t lzbench_brotli_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_brotli_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_brotli_stream_init(size_t insize, size_t level, size_t);
+	void lzbench_brotli_stream_deinit(char* workmem);
+	int64_t lzbench_brotli_stream_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_brotli_stream_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 #else
 	#define lzbench_brotli_compress NULL
 	#define lzbench_brotli_decompress NULL
+	#define lzbench_brotli_adv_init NULL
+	#define lzbench_brotli_adv_compress NULL
+	#define lzbench_brotli_adv_decompress NULL
+	#define lzbench_brotli_linked_init NULL
+	#define lzbench_brotli_linked_deinit NULL
+	#define lzbench_brotli_linked_reset NULL
+	#define lzbench_brotli_linked_compress NULL
+	#define lzbench_brotli_linked_decompress NULL
+	#define lzbench_brotli_stream_init NULL
+	#define lzbench_brotli_stream_deinit NULL
+	#define lzbench_brotli_stream_compress NULL
+	#define lzbench_brotli_stream_decompress NULL
 #endif
 
 
@@ -120,9 +145,13 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 #ifndef BENCH_REMOVE_LIBDEFLATE
 	int64_t lzbench_libdeflate_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 	int64_t lzbench_libdeflate_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_libdeflate_gzip_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_libdeflate_gzip_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 #else
 	#define lzbench_libdeflate_compress NULL
 	#define lzbench_libdeflate_decompress NULL
+	#define lzbench_libdeflate_gzip_compress NULL
+	#define lzbench_libdeflate_gzip_decompress NULL
 #endif
 
 
@@ -140,11 +169,33 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 	int64_t lzbench_lz4fast_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize,  size_t level, size_t, char*);
 	int64_t lzbench_lz4hc_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize,  size_t level, size_t, char*);
 	int64_t lzbench_lz4_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_lz4frame_init(size_t insize, size_t level, size_t);
+	void lzbench_lz4frame_deinit(char* workmem);
+	int64_t lzbench_lz4frame_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_lz4frame_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_lz4_linked_init(size_t insize, size_t level, size_t);
+	void lzbench_lz4_linked_deinit(char* workmem);
+	void lzbench_lz4_linked_reset(char* workmem);
+	int64_t lzbench_lz4_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_lz4fast_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_lz4hc_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
+	int64_t lzbench_lz4_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 #else
 	#define lzbench_lz4_compress NULL
 	#define lzbench_lz4fast_compress NULL
 	#define lzbench_lz4hc_compress NULL
 	#define lzbench_lz4_decompress NULL
+	#define lzbench_lz4frame_init NULL
+	#define lzbench_lz4frame_deinit NULL
+	#define lzbench_lz4frame_compress NULL
+	#define lzbench_lz4frame_decompress NULL
+	#define lzbench_lz4_linked_init NULL
+	#define lzbench_lz4_linked_deinit NULL
+	#define lzbench_lz4_linked_reset NULL
+	#define lzbench_lz4_linked_compress NULL
+	#define lzbench_lz4fast_linked_compress NULL
+	#define lzbench_lz4hc_linked_compress NULL
+	#define lzbench_lz4_linked_decompress NULL
 #endif
 
 
@@ -222,9 +273,13 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 #ifndef BENCH_REMOVE_LZMA
 	int64_t lzbench_lzma_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 	int64_t lzbench_lzma_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_lzma_adv_init(size_t insize, size_t level, size_t);
+	int64_t lzbench_lzma_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 #else
 	#define lzbench_lzma_compress NULL
 	#define lzbench_lzma_decompress NULL
+	#define lzbench_lzma_adv_init NULL
+	#define lzbench_lzma_adv_compress NULL
 #endif
 
 
@@ -304,6 +359,7 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
     void lzbench_lzsse4_deinit(char* workmem);
     int64_t lzbench_lzsse4_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
     int64_t lzbench_lzsse4_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+    int64_t lzbench_lzsse4_avx2_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
     char* lzbench_lzsse4fast_init(size_t insize, size_t level, size_t);
     void lzbench_lzsse4fast_deinit(char* workmem);
     int64_t lzbench_lzsse4fast_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
@@ -311,6 +367,7 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
     void lzbench_lzsse8_deinit(char* workmem);
     int64_t lzbench_lzsse8_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
     int64_t lzbench_lzsse8_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+    int64_t lzbench_lzsse8_avx2_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
     char* lzbench_lzsse8fast_init(size_t insize, size_t level, size_t);
     void lzbench_lzsse8fast_deinit(char* workmem);
     int64_t lzbench_lzsse8fast_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
@@ -323,6 +380,7 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
     #define lzbench_lzsse4_deinit NULL
     #define lzbench_lzsse4_compress NULL
     #define lzbench_lzsse4_decompress NULL
+    #define lzbench_lzsse4_avx2_decompress NULL
     #define lzbench_lzsse4fast_init NULL
     #define lzbench_lzsse4fast_deinit NULL
     #define lzbench_lzsse4fast_compress NULL
@@ -330,6 +388,7 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
     #define lzbench_lzsse8_deinit NULL
     #define lzbench_lzsse8_compress NULL
     #define lzbench_lzsse8_decompress NULL
+    #define lzbench_lzsse8_avx2_decompress NULL
     #define lzbench_lzsse8fast_init NULL
     #define lzbench_lzsse8fast_deinit NULL
     #define lzbench_lzsse8fast_compress NULL
@@ -436,9 +495,13 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 #ifndef BENCH_REMOVE_XZ
 	int64_t lzbench_xz_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 	int64_t lzbench_xz_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_xz_adv_init(size_t insize, size_t level, size_t);
+	int64_t lzbench_xz_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*);
 #else
 	#define lzbench_xz_compress NULL
 	#define lzbench_xz_decompress NULL
+	#define lzbench_xz_adv_init NULL
+	#define lzbench_xz_adv_compress NULL
 #endif
 
 
@@ -465,9 +528,35 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 #ifndef BENCH_REMOVE_ZLIB
 	int64_t lzbench_zlib_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 	int64_t lzbench_zlib_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_zlib_linked_init(size_t insize, size_t level, size_t);
+	void lzbench_zlib_linked_deinit(char* workmem);
+	void lzbench_zlib_linked_reset(char* workmem);
+	int64_t lzbench_zlib_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_zlib_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_zlib_stream_init(size_t insize, size_t level, size_t);
+	void lzbench_zlib_stream_deinit(char* workmem);
+	int64_t lzbench_zlib_stream_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_zlib_stream_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 #else
 	#define lzbench_zlib_compress NULL
 	#define lzbench_zlib_decompress NULL
+	#define lzbench_zlib_linked_init NULL
+	#define lzbench_zlib_linked_deinit NULL
+	#define lzbench_zlib_linked_reset NULL
+	#define lzbench_zlib_linked_compress NULL
+	#define lzbench_zlib_linked_decompress NULL
+	#define lzbench_zlib_stream_init NULL
+	#define lzbench_zlib_stream_deinit NULL
+	#define lzbench_zlib_stream_compress NULL
+	#define lzbench_zlib_stream_decompress NULL
+#endif
+
+#ifndef BENCH_REMOVE_ZLIB
+	int64_t lzbench_zlib_simd_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_zlib_simd_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+#else
+	#define lzbench_zlib_simd_compress NULL
+	#define lzbench_zlib_simd_decompress NULL
 #endif
 
 
@@ -487,6 +576,15 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 	int64_t lzbench_zstd_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 	char* lzbench_zstd_LDM_init(size_t insize, size_t level, size_t);
 	int64_t lzbench_zstd_LDM_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_zstd_chk_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_zstd_adv_init(size_t insize, size_t level, size_t);
+	char* lzbench_zstd_adv_search_init(size_t insize, size_t level, size_t);
+	int64_t lzbench_zstd_adv_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	char* lzbench_zstd_linked_init(size_t insize, size_t level, size_t);
+	void lzbench_zstd_linked_deinit(char* workmem);
+	void lzbench_zstd_linked_reset(char* workmem);
+	int64_t lzbench_zstd_linked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
+	int64_t lzbench_zstd_linked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*);
 #else
 	#define lzbench_zstd_init NULL
 	#define lzbench_zstd_deinit NULL
@@ -494,6 +592,15 @@ int64_t lzbench_return_0(char *inbuf, size_t insize, char *outbuf, size_t outsiz
 	#define lzbench_zstd_decompress NULL
 	#define lzbench_zstd_LDM_init NULL
 	#define lzbench_zstd_LDM_compress NULL
+	#define lzbench_zstd_chk_compress NULL
+	#define lzbench_zstd_adv_init NULL
+	#define lzbench_zstd_adv_search_init NULL
+	#define lzbench_zstd_adv_compress NULL
+	#define lzbench_zstd_linked_init NULL
+	#define lzbench_zstd_linked_deinit NULL
+	#define lzbench_zstd_linked_reset NULL
+	#define lzbench_zstd_linked_compress NULL
+	#define lzbench_zstd_linked_decompress NULL
 #endif
 
 
@@ -0,0 +1,232 @@
+// synthetic input data (--gen option) for hosts without access to real corpora
+
+#include "datagen.h"
+#include <math.h>
+#include <string.h>
+
+#define LIT_TABLE_LOG 12
+#define DIST_TABLE_LOG 10
+#define MIN_MATCH 4
+#define MAX_MATCH 65535
+#define MIXED_SEGMENT (1<<20)
+
+
+static const datagen_params_t datagen_presets[] =
+{
+    // name          entropy match  mlen  offset   rep   alphabet
+    { "text",         4.5,   0.70,    8,   32768,  0.02, " etaoinsrhldcumfpgwybvkxjqz\n.,ETAOINSRHLDCUMFPGWYBVKXJQZ'\"-()0123456789;:!?", 0, 0 },
+    { "json",         4.8,   0.80,   18,   16384,  0.15, "\"e:,at s{}ionr0123456789lcdmTZ-_.puhgfbyvkwx[]ABCDEFGHIJKLMNOPQRSUVWXY/\n", 0, 0 },
+    { "numeric",      3.0,   0.45,    6,    4096,  0.50, NULL, 0, 0 },
+    { "compressed",   8.0,   0.00,    4,       1,  0.00, NULL, 0, 0 },
+};
+
+#define DATAGEN_PRESETS_COUNT (sizeof(datagen_presets)/sizeof(datagen_presets[0]))
+
+
+bool datagen_preset(datagen_params_t* gp, const char* name)
+{
+    uint64_t seed = gp->seed;
+
+    if (!strcmp(name, "mixed"))
+    {
+        *gp = datagen_presets[0];
+        gp->name = "mixed";
+        gp->mixed = 1;
+        gp->seed = seed;
+        return true;
+    }
+
+    for (size_t i=0; i<DATAGEN_PRESETS_COUNT; i++)
+        if (!strcmp(name, datagen_presets[i].name))
+        {
+            *gp = datagen_presets[i];
+            gp->seed = seed;
+            return true;
+        }
+
+    return false;
+}
+
+
+typedef struct
+{
+    uint64_t state;
+    uint8_t  literals[1 << LIT_TABLE_LOG];
+    uint32_t litrun[1 << DIST_TABLE_LOG];
+    uint32_t mlen[1 << DIST_TABLE_LOG];
+    uint32_t offset[1 << DIST_TABLE_LOG];
+    uint32_t rep;     // probability of repeating the previous offset scaled to 2^32
+    int no_matches;
+} datagen_tables_t;
+
+
+static inline uint64_t datagen_rand(datagen_tables_t* t)
+{
+    // xorshift64*
+    t->state ^= t->state >> 12;
+    t->state ^= t->state << 25;
+    t->state ^= t->state >> 27;
+    return t->state * 2685821657736338717ULL;
+}
+
+
+static double geometric_entropy(double r)
+{
+    double sum = 0, h = 0, p = 1;
+    for (int i=0; i<256; i++, p *= r) sum += p;
+    p = 1;
+    for (int i=0; i<256; i++, p *= r)
+        if (p/sum > 0) h -= (p/sum) * log2(p/sum);
+    return h;
+}
+
+
+static void datagen_build_tables(datagen_tables_t* t, const datagen_params_t* gp)
+{
+    uint8_t order[256];
+    bool used[256];
+    uint32_t count[256];
+    double lo = 0, hi = 1, r, p, sum;
+    size_t n = 0, pos = 0;
+    const double u_scale = 1.0 / (1 << DIST_TABLE_LOG);
+
+    t->state = gp->seed * 0x9E3779B97F4A7C15ULL + 0x2545F4914F6CDD1DULL;
+    if (!t->state) t->state = 1;
+
+    // literal alphabet ordered from the most probable symbol
+    memset(used, 0, sizeof(used));
+    if (gp->alphabet)
+        for (const char* a = gp->alphabet; *a && n < 256; a++)
+            if (!used[(uint8_t)*a]) { used[(uint8_t)*a] = true; order[n++] = *a; }
+    for (int c=0; c<256; c++)
+        if (!used[c]) order[n++] = c;
+
+    // p(i) ~ r^i, bisection on r to get the requested entropy
+    if (gp->entropy >= 8.0) r = 1;
+    else if (gp->entropy <= 0.0) r = 0;
+    else
+    {
+        for (int it=0; it<60; it++)
+        {
+            r = (lo + hi) / 2;
+            if (geometric_entropy(r) < gp->entropy) lo = r; else hi = r;
+        }
+        r = (lo + hi) / 2;
+    }
+
+    sum = 0; p = 1;
+    for (int i=0; i<256; i++, p *= r) sum += p;
+    p = 1;
+    for (int i=0; i<256; i++, p *= r)
+    {
+        count[i] = (uint32_t)floor(p / sum * (1 << LIT_TABLE_LOG));
+        pos += count[i];
+    }
+    count[0] += (1 << LIT_TABLE_LOG) - pos; // rounding leftovers go to the most probable symbol
+    pos = 0;
+    for (int i=0; i<256; i++)
+        for (uint32_t j=0; j<count[i]; j++)
+            t->literals[pos++] = order[i];
+
+    // inverse CDFs: geometric match and literal run lengths, log-uniform offsets
+    double mlen_mean = gp->mlen > MIN_MATCH ? gp->mlen - MIN_MATCH : 0;
+    double match = gp->match < 0 ? 0 : gp->match > 1 ? 1 : gp->match;
+    double litrun_mean = match > 0 ? (mlen_mean + MIN_MATCH) * (1 - match) / match : 0;
+    uint32_t max_offset = gp->offset ? gp->offset : 1;
+
+    t->no_matches = (match <= 0);
+    t->rep = (uint32_t)(gp->rep * 4294967295.0);
+    for (int i=0; i<(1 << DIST_TABLE_LOG); i++)
+    {
+        double u = (i + 0.5) * u_scale;
+        double len = MIN_MATCH + floor(-log(1 - u) * mlen_mean);
+        t->mlen[i] = len > MAX_MATCH ? MAX_MATCH : (uint32_t)len;
+        t->litrun[i] = (uint32_t)floor(-log(1 - u) * litrun_mean + 0.5);
+        t->offset[i] = (uint32_t)floor(exp(u * log((double)max_offset)));
+        if (t->offset[i] < 1) t->offset[i] = 1;
+        if (t->offset[i] > max_offset) t->offset[i] = max_offset;
+    }
+}
+
+
+/* writes up to 8 bytes past the run, short runs are branchless */
+static inline void datagen_literals(datagen_tables_t* t, uint8_t* out, size_t run)
+{
+    const uint32_t mask = (1 << LIT_TABLE_LOG) - 1;
+    size_t i = 0;
+
+    if (run <= 8) run = 8;
+    for (; i<run; i+=4)
+    {
+        uint64_t rnd = datagen_rand(t);
+        out[i] = t->literals[rnd & mask];
+        out[i+1] = t->literals[(rnd >> 16) & mask];
+        out[i+2] = t->literals[(rnd >> 32) & mask];
+        out[i+3] = t->literals[(rnd >> 48) & mask];
+    }
+}
+
+
+static void datagen_segment(datagen_tables_t* t, uint8_t* buf, size_t pos, size_t end)
+{
+    const uint32_t mask = (1 << DIST_TABLE_LOG) - 1;
+    size_t last_offset = 1;
+
+    if (t->no_matches)
+    {
+        datagen_literals(t, buf + pos, end - pos);
+        return;
+    }
+
+    while (pos < end)
+    {
+        uint64_t rnd = datagen_rand(t);
+        size_t run = t->litrun[rnd & mask];
+        size_t len = t->mlen[(rnd >> 10) & mask];
+        size_t offset = ((uint32_t)(rnd >> 32) < t->rep) ? last_offset : t->offset[(rnd >> 20) & mask];
+
+        if (pos == 0 && run == 0) run = 1;
+        if (run > end - pos) run = end - pos;
+        datagen_literals(t, buf + pos, run);
+        pos += run;
+        if (pos >= end) break;
+
+        if (offset > pos) offset = pos;
+        if (len > end - pos) len = end - pos;
+        uint8_t* dst = buf + pos;
+        const uint8_t* src = dst - offset;
+        if (offset >= 16 && len <= 16)
+            memcpy(dst, src, 16);
+        else if (offset >= 8)
+            for (size_t i=0; i<len; i+=8) memcpy(dst + i, src + i, 8); // up to 7 bytes past the match
+        else
+            for (size_t i=0; i<len; i++) dst[i] = src[i]; // overlapping copy repeats the pattern
+        pos += len;
+        last_offset = offset;
+    }
+}
+
+
+void datagen_generate(const datagen_params_t* gp, uint8_t* buf, size_t size)
+{
+    datagen_tables_t* tables = new datagen_tables_t[gp->mixed ? DATAGEN_PRESETS_COUNT : 1];
+
+    if (!gp->mixed)
+    {
+        datagen_build_tables(&tables[0], gp);
+        datagen_segment(&tables[0], buf, 0, size);
+    }
+    else
+    {
+        for (size_t i=0; i<DATAGEN_PRESETS_COUNT; i++)
+        {
+            datagen_params_t preset = datagen_presets[i];
+            preset.seed = gp->seed + i;
+            datagen_build_tables(&tables[i], &preset);
+        }
+        for (size_t pos=0, seg=0; pos < size; pos += MIXED_SEGMENT, seg++)
+            datagen_segment(&tables[seg % DATAGEN_PRESETS_COUNT], buf, pos, (size - pos < MIXED_SEGMENT) ? size : pos + MIXED_SEGMENT);
+    }
+
+    delete[] tables;
+}
@@ -0,0 +1,32 @@
+#ifndef LZBENCH_DATAGEN_H
+#define LZBENCH_DATAGEN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Synthetic LZ-style data: literal runs drawn from an order-0 distribution with a given
+ * entropy, interleaved with matches copied from the already generated data.
+ * The output depends only on the parameters and the seed.
+ */
+typedef struct
+{
+    const char* name;
+    double entropy;      // entropy of literals in bits per byte (0-8)
+    double match;        // fraction of output bytes covered by matches (0-1)
+    uint32_t mlen;       // average match length (minimum is 4)
+    uint32_t offset;     // maximum match offset, offsets are log-uniform in [1, offset]
+    double rep;          // probability of reusing the previous offset
+    const char* alphabet; // literals ordered from the most frequent, NULL = byte values 0..255
+    int mixed;           // cycle all presets in 1 MB segments
+    uint64_t seed;
+} datagen_params_t;
+
+#define DATAGEN_PRESETS "text, json, numeric, compressed, mixed"
+
+#define DATAGEN_SLACK 16 // buf passed to datagen_generate() must have size + DATAGEN_SLACK bytes
+
+bool datagen_preset(datagen_params_t* gp, const char* name);
+void datagen_generate(const datagen_params_t* gp, uint8_t* buf, size_t size);
+
+#endif
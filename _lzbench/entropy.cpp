@@ -0,0 +1,305 @@
+// order-0 entropy coders measured by the -E option
+
+#include "entropy.h"
+#include <string.h>
+
+#define HUF_STATIC_LINKING_ONLY
+#include "zstd/lib/common/huf.h"
+#include "zstd/lib/common/fse.h"
+
+extern "C"
+{
+#include "lzfse/lzfse_fse.h"
+}
+
+#ifndef BENCH_REMOVE_LZ4
+#include "lz4/lz4.h"
+#endif
+
+enum { BLOCK_RAW=0, BLOCK_RLE, BLOCK_CODED };
+
+#define BLOCK_HEADER 4
+#define BLOCK_SIZE_MASK ((1U << 30) - 1)
+
+/* one block: returns the coded size, 0 if it does not compress, 1 if it is a single symbol (RLE) */
+typedef size_t (*block_encode_func)(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize);
+/* returns srcsize or 0 on error */
+typedef size_t (*block_decode_func)(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize);
+
+
+static void write_header(uint8_t* p, uint32_t mode, uint32_t size)
+{
+    uint32_t v = (mode << 30) | size;
+    p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+
+
+static int64_t entropy_encode(block_encode_func encode, const uint8_t* in, size_t insize, uint8_t* out, size_t outsize)
+{
+    uint8_t* op = out;
+    uint8_t* oend = out + outsize;
+
+    for (size_t part; insize > 0; in += part, insize -= part)
+    {
+        part = (insize > ENTROPY_BLOCK_SIZE) ? ENTROPY_BLOCK_SIZE : insize;
+        if (oend - op < (ptrdiff_t)(BLOCK_HEADER + part)) return 0;
+
+        size_t csize = encode(op + BLOCK_HEADER, part - 1, in, part);
+        if (csize == 1)
+        {
+            write_header(op, BLOCK_RLE, 1);
+            op[BLOCK_HEADER] = in[0];
+        }
+        else if (csize == 0 || csize >= part)
+        {
+            write_header(op, BLOCK_RAW, part);
+            memcpy(op + BLOCK_HEADER, in, part);
+            csize = part;
+        }
+        else
+            write_header(op, BLOCK_CODED, csize);
+        op += BLOCK_HEADER + csize;
+    }
+    return op - out;
+}
+
+
+static int64_t entropy_decode(block_decode_func decode, const uint8_t* in, size_t insize, uint8_t* out, size_t outsize)
+{
+    const uint8_t* iend = in + insize;
+    uint8_t* op = out;
+
+    for (size_t part; outsize > 0; op += part, outsize -= part)
+    {
+        part = (outsize > ENTROPY_BLOCK_SIZE) ? ENTROPY_BLOCK_SIZE : outsize;
+        if (iend - in < BLOCK_HEADER) return 0;
+
+        uint32_t v = in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+        size_t csize = v & BLOCK_SIZE_MASK;
+        in += BLOCK_HEADER;
+        if ((size_t)(iend - in) < csize) return 0;
+
+        switch (v >> 30)
+        {
+            case BLOCK_RAW: if (csize != part) return 0; memcpy(op, in, part); break;
+            case BLOCK_RLE: memset(op, in[0], part); break;
+            case BLOCK_CODED: if (decode(op, part, in, csize) != part) return 0; break;
+            default: return 0;
+        }
+        in += csize;
+    }
+    return op - out;
+}
+
+
+/* zstd: Huffman with 4 interleaved streams (the literals of zstd blocks), single stream, and FSE */
+
+static size_t huf_encode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    size_t r = HUF_compress(dst, dstsize, src, srcsize);
+    return HUF_isError(r) ? 0 : r;
+}
+
+static size_t huf_decode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    HUF_DTable huf_dtable[HUF_DTABLE_SIZE(HUF_TABLELOG_MAX)];  // 16 KB, on the stack of each call
+    huf_dtable[0] = (HUF_DTable)HUF_TABLELOG_MAX * 0x01000001;
+    size_t r = HUF_decompress4X_DCtx(huf_dtable, dst, dstsize, src, srcsize);
+    return HUF_isError(r) ? 0 : r;
+}
+
+static size_t huf1x_encode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    size_t r = HUF_compress1X(dst, dstsize, src, srcsize, 255, HUF_TABLELOG_DEFAULT);
+    return HUF_isError(r) ? 0 : r;
+}
+
+static size_t huf1x_decode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    HUF_DTable huf_dtable[HUF_DTABLE_SIZE(HUF_TABLELOG_MAX)];
+    huf_dtable[0] = (HUF_DTable)HUF_TABLELOG_MAX * 0x01000001;
+    size_t r = HUF_decompress1X_DCtx(huf_dtable, dst, dstsize, src, srcsize);
+    return HUF_isError(r) ? 0 : r;
+}
+
+static size_t fse_encode_zstd(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    size_t r = FSE_compress(dst, dstsize, src, srcsize);
+    return FSE_isError(r) ? 0 : r;
+}
+
+static size_t fse_decode_zstd(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    size_t r = FSE_decompress(dst, dstsize, src, srcsize);
+    return FSE_isError(r) ? 0 : r;
+}
+
+
+/*
+ * lzfse: the literal coder of lzfse blocks, 4 interleaved FSE states over 1024 states.
+ * Block: 4 x 16-bit final states, bits of the last byte + 7, 32-bit payload size,
+ * 256 normalized frequencies as 7-bit varints, payload written backwards.
+ */
+#define LZFSE_ENTROPY_STATES 1024
+#define LZFSE_ENTROPY_SYMBOLS 256
+
+static inline uint8_t lzfse_symbol(const uint8_t* src, size_t n, size_t i) { return (i < n) ? src[i] : src[n-1]; }
+
+static size_t lzfse_block_encode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    uint32_t occ[LZFSE_ENTROPY_SYMBOLS];
+    uint16_t freq[LZFSE_ENTROPY_SYMBOLS];
+    fse_encoder_entry encoder[LZFSE_ENTROPY_SYMBOLS];
+    size_t n4 = (srcsize + 3) & ~(size_t)3;   // padded with the last symbol
+    uint8_t *op = dst, *oend = dst + dstsize;
+
+    memset(occ, 0, sizeof(occ));
+    for (size_t i=0; i<n4; i++) occ[lzfse_symbol(src, srcsize, i)]++;
+    if (occ[src[0]] == n4) return 1;
+
+    fse_normalize_freq(LZFSE_ENTROPY_STATES, LZFSE_ENTROPY_SYMBOLS, occ, freq);
+    fse_init_encoder_table(LZFSE_ENTROPY_STATES, LZFSE_ENTROPY_SYMBOLS, freq, encoder);
+
+    op += 13;
+    for (int i=0; i<LZFSE_ENTROPY_SYMBOLS; i++)
+    {
+        if (oend - op < 2) return 0;
+        if (freq[i] >= 0x80) *op++ = 0x80 | (freq[i] & 0x7F);
+        *op++ = (freq[i] >= 0x80) ? (freq[i] >> 7) : freq[i];
+    }
+
+    fse_out_stream out;
+    fse_state state0 = 0, state1 = 0, state2 = 0, state3 = 0;
+    uint8_t* payload = op;
+    fse_out_init(&out);
+    // encoded from the last symbol, so the decoder starts with the first
+    for (size_t i=n4; i>0; )
+    {
+        if (oend - op < 16) return 0;
+        i -= 4;
+        fse_encode(&state3, encoder, &out, lzfse_symbol(src, srcsize, i + 3));
+        fse_encode(&state2, encoder, &out, lzfse_symbol(src, srcsize, i + 2));
+#if !FSE_IOSTREAM_64
+        fse_out_flush(&out, &op);
+#endif
+        fse_encode(&state1, encoder, &out, lzfse_symbol(src, srcsize, i + 1));
+        fse_encode(&state0, encoder, &out, lzfse_symbol(src, srcsize, i + 0));
+        fse_out_flush(&out, &op);
+    }
+    if (oend - op < 8) return 0;
+    fse_out_finish(&out, &op);
+
+    uint32_t payload_size = (uint32_t)(op - payload);
+    fse_state states[4] = { state0, state1, state2, state3 };
+    for (int s=0; s<4; s++) { dst[2*s] = (uint8_t)states[s]; dst[2*s+1] = (uint8_t)(states[s] >> 8); }
+    dst[8] = (uint8_t)(out.accum_nbits + 7);
+    memcpy(dst + 9, &payload_size, 4);
+    return op - dst;
+}
+
+static size_t lzfse_block_decode(uint8_t* dst, size_t dstsize, const uint8_t* src, size_t srcsize)
+{
+    uint16_t freq[LZFSE_ENTROPY_SYMBOLS];
+    int32_t decoder[LZFSE_ENTROPY_STATES];
+    const uint8_t *ip = src + 13, *iend = src + srcsize;
+    uint32_t payload_size;
+    uint8_t tail[4];
+
+    if (srcsize < 13) return 0;
+    for (int i=0; i<LZFSE_ENTROPY_SYMBOLS; i++)
+    {
+        if (ip >= iend) return 0;
+        freq[i] = *ip & 0x7F;
+        if (*ip++ & 0x80)
+        {
+            if (ip >= iend) return 0;
+            freq[i] |= *ip++ << 7;
+        }
+    }
+    if (fse_check_freq(freq, LZFSE_ENTROPY_SYMBOLS, LZFSE_ENTROPY_STATES) != 0) return 0;
+    if (fse_init_decoder_table(LZFSE_ENTROPY_STATES, LZFSE_ENTROPY_SYMBOLS, freq, decoder) != 0) return 0;
+
+    memcpy(&payload_size, src + 9, 4);
+    if (payload_size > (size_t)(iend - ip)) return 0;
+
+    fse_in_stream in;
+    const uint8_t* buf = ip + payload_size;   // read backwards from the end, src is the lower bound
+    if (fse_in_init(&in, (fse_bit_count)src[8] - 7, &buf, src) != 0) return 0;
+
+    fse_state state0 = src[0] | (src[1] << 8), state1 = src[2] | (src[3] << 8);
+    fse_state state2 = src[4] | (src[5] << 8), state3 = src[6] | (src[7] << 8);
+    if ((state0 | state1 | state2 | state3) >= LZFSE_ENTROPY_STATES) return 0;
+
+    size_t i = 0;
+    for (; i + 4 <= dstsize; i += 4)
+    {
+        if (fse_in_flush(&in, &buf, src) != 0) return 0;
+        dst[i + 0] = fse_decode(&state0, decoder, &in);
+        dst[i + 1] = fse_decode(&state1, decoder, &in);
+#if !FSE_IOSTREAM_64
+        if (fse_in_flush(&in, &buf, src) != 0) return 0;
+#endif
+        dst[i + 2] = fse_decode(&state2, decoder, &in);
+        dst[i + 3] = fse_decode(&state3, decoder, &in);
+    }
+    if (i < dstsize)
+    {
+        if (fse_in_flush(&in, &buf, src) != 0) return 0;
+        tail[0] = fse_decode(&state0, decoder, &in);
+        tail[1] = fse_decode(&state1, decoder, &in);
+#if !FSE_IOSTREAM_64
+        if (fse_in_flush(&in, &buf, src) != 0) return 0;
+#endif
+        tail[2] = fse_decode(&state2, decoder, &in);
+        tail[3] = fse_decode(&state3, decoder, &in);
+        memcpy(dst + i, tail, dstsize - i);
+    }
+    return dstsize;
+}
+
+
+static int64_t huf_compress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_encode(huf_encode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t huf_decompress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_decode(huf_decode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t huf1x_compress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_encode(huf1x_encode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t huf1x_decompress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_decode(huf1x_decode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t fse_compress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_encode(fse_encode_zstd, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t fse_decompress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_decode(fse_decode_zstd, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t fse_lzfse_compress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_encode(lzfse_block_encode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+static int64_t fse_lzfse_decompress(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*) { return entropy_decode(lzfse_block_decode, (uint8_t*)in, insize, (uint8_t*)out, outsize); }
+
+
+const entropy_desc_t entropy_desc[] =
+{
+    { "huf",        "zstd 1.4.8",       4, huf_compress,        huf_decompress },
+    { "huf1x",      "zstd 1.4.8",       1, huf1x_compress,      huf1x_decompress },
+    { "fse",        "zstd 1.4.8",       2, fse_compress,        fse_decompress },
+    { "fse_lzfse",  "lzfse 2017-03-08", 4, fse_lzfse_compress,  fse_lzfse_decompress },
+};
+
+const int entropy_desc_count = sizeof(entropy_desc) / sizeof(entropy_desc[0]);
+
+
+size_t entropy_lz4_literals(const uint8_t* in, size_t insize, uint8_t* out, uint8_t* tmp, size_t tmpsize)
+{
+#ifndef BENCH_REMOVE_LZ4
+    int clen = LZ4_compress_default((const char*)in, (char*)tmp, (int)insize, (int)tmpsize);
+    const uint8_t *ip = tmp, *iend = tmp + (clen > 0 ? clen : 0);
+    uint8_t* op = out;
+
+    while (ip < iend)
+    {
+        size_t len = *ip >> 4;
+        size_t mlen = *ip++ & 15;
+        if (len == 15) { uint8_t b; do { b = *ip++; len += b; } while (b == 255); }
+        memcpy(op, ip, len);
+        op += len;
+        ip += len;
+        if (ip >= iend) break;   // the last sequence has only literals
+        ip += 2;                 // offset
+        if (mlen == 15) { uint8_t b; do { b = *ip++; } while (b == 255); }
+    }
+    return op - out;
+#else
+    return 0;
+#endif
+}
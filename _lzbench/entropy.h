@@ -0,0 +1,32 @@
+#ifndef LZBENCH_ENTROPY_H
+#define LZBENCH_ENTROPY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Order-0 entropy coders vendored by the compressors, for the -E option. Each chunk is split into
+ * ENTROPY_BLOCK_SIZE blocks with a 4-byte header (mode in the top 2 bits, coded size below), a block
+ * that does not compress is stored and a block of one symbol is stored as RLE. The functions have the
+ * compress_func signature, so lzbench_test() runs them like codecs.
+ */
+#define ENTROPY_BLOCK_SIZE (128*1024)   // HUF_BLOCKSIZE_MAX
+
+typedef int64_t (*entropy_func)(char *in, size_t insize, char *out, size_t outsize, size_t, size_t, char*);
+
+typedef struct
+{
+    const char* name;
+    const char* version;
+    int streams;            // interleaved streams or states of the decoder
+    entropy_func compress;
+    entropy_func decompress;
+} entropy_desc_t;
+
+extern const entropy_desc_t entropy_desc[];
+extern const int entropy_desc_count;
+
+/* writes the literals of an lz4 pass over one chunk to out (tmp holds LZ4_compressBound(insize)), returns their number */
+size_t entropy_lz4_literals(const uint8_t* in, size_t insize, uint8_t* out, uint8_t* tmp, size_t tmpsize);
+
+#endif
@@ -0,0 +1,74 @@
+// run-time selection of the instruction set variants of the hot codecs
+
+#include "isa.h"
+#include <string.h>
+
+#ifdef BENCH_HAS_ISA_VARIANTS
+extern "C"
+{
+    // isa/avx2/isa-codecs.o and isa/avx512/isa-codecs.o
+    extern const isa_func_t avx2_lzbench_isa_funcs[];
+    extern const isa_func_t avx512_lzbench_isa_funcs[];
+}
+
+static const isa_func_t* isa_tables[ISA_COUNT] = { lzbench_isa_funcs, avx2_lzbench_isa_funcs, avx512_lzbench_isa_funcs };
+#else
+static const isa_func_t* isa_tables[ISA_COUNT] = { lzbench_isa_funcs, NULL, NULL };
+#endif
+
+const char* isa_names[ISA_COUNT] = { "base", "avx2", "avx512" };
+
+
+int isa_find(const char* name)
+{
+    for (int i=0; i<ISA_COUNT; i++)
+        if (!strcmp(name, isa_names[i])) return i;
+    return -1;
+}
+
+
+bool isa_available(int isa)
+{
+    if (isa < 0 || isa >= ISA_COUNT || !isa_tables[isa]) return false;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // the features enabled by ISA_FLAGS_avx2 and ISA_FLAGS_avx512 in the Makefile
+    if (isa >= ISA_AVX2 && !(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+        && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")))
+        return false;
+    if (isa >= ISA_AVX512 && !(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+        && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq")))
+        return false;
+#endif
+    return true;
+}
+
+
+int isa_best()
+{
+    int isa = ISA_COUNT - 1;
+    while (isa > ISA_BASE && !isa_available(isa)) isa--;
+    return isa;
+}
+
+
+static int isa_index(isa_func_t func)
+{
+    if (!func) return -1;
+    for (int i=0; i<lzbench_isa_funcs_count; i++)
+        if (lzbench_isa_funcs[i] == func) return i;
+    return -1;
+}
+
+
+bool isa_has_variant(isa_func_t func)
+{
+    return isa_index(func) >= 0;
+}
+
+
+isa_func_t isa_variant(int isa, isa_func_t func)
+{
+    int idx = isa_index(func);
+    if (idx < 0 || !isa_available(isa)) return func;
+    return isa_tables[isa][idx];
+}
@@ -0,0 +1,30 @@
+#ifndef LZBENCH_ISA_H
+#define LZBENCH_ISA_H
+
+/*
+ * Instruction set variants of the hot codecs (lz4, lizard, zstd, libdeflate, snappy, brotli, lzsse).
+ * With BUILD_ISA_VARIANTS the Makefile builds these codecs and compressors.cpp again for each
+ * ISA and prefixes the symbols of each copy, so every copy has its own lzbench_isa_funcs[] with
+ * the wrappers in the same order. ISA_BASE is the default build, with the flags of the compiler
+ * (SSE2 on x86-64) except for lzsse, which is always built with SSE4.1.
+ */
+enum isa_e { ISA_BASE=0, ISA_AVX2, ISA_AVX512, ISA_COUNT };
+
+typedef void (*isa_func_t)();
+
+extern "C"
+{
+    // compressors.cpp, the wrappers that have variants
+    extern const isa_func_t lzbench_isa_funcs[];
+    extern const int lzbench_isa_funcs_count;
+}
+
+extern const char* isa_names[ISA_COUNT];
+
+int isa_find(const char* name);     // -1 if unknown
+bool isa_available(int isa);        // built and supported by the CPU
+int isa_best();
+bool isa_has_variant(isa_func_t func);
+isa_func_t isa_variant(int isa, isa_func_t func);  // func itself if it has no variant
+
+#endif
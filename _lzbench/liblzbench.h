@@ -0,0 +1,112 @@
+#ifndef LIBLZBENCH_H
+#define LIBLZBENCH_H
+
+/*
+ * C API of liblzbench.a / liblzbench.so (make liblzbench.a), the measurement loop of lzbench for
+ * programs that pick a codec for their hardware and data at run time:
+ *
+ *   lzbench_bench_options_t opt;
+ *   lzbench_result_t results[64];
+ *   lzbench_bench_defaults(&opt);
+ *   opt.chunk_size = 64 << 10;
+ *   int n = lzbench_bench("lz4/zstd,1,3/brotli,1", data, size, &opt, results, 64);
+ *
+ * The functions are reentrant and may run on several threads at once; each call allocates its own
+ * buffers and prints no results. Codecs whose library keeps global state are run by one call at a time.
+ * Link with -pthread -ldl (and -lstdc++ from C).
+ *
+ * A session is the lzbench command line, which is a client of it: it takes the options of lzbench one by
+ * one, prints the rows of each input in the -o format and the reports, cache statistics, comparison and
+ * sorted table at the end:
+ *
+ *   lzbench_session_t* s = lzbench_session_new();
+ *   lzbench_session_option(s, "-ezstd,1,3");
+ *   lzbench_session_option(s, "--compare=base.json");
+ *   lzbench_session_run(s, files, count);
+ *   int status = lzbench_session_finish(s);
+ *   lzbench_session_free(s);
+ *
+ * A session is used by one thread at a time. --plugin loads codecs for the whole process and the session
+ * raises the priority of the process unless -x is given.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    const char* name;          // as in -e
+    const char* version;
+    int first_level;
+    int last_level;
+    const char* keys;          // key=value parameters accepted after the name, or NULL
+} lzbench_codec_info_t;
+
+typedef struct
+{
+    size_t chunk_size;         // compress the data in independent chunks of this size, 0 = in one piece
+    uint32_t ctime_ms;         // time budget of each codec for compression and decompression,
+    uint32_t dtime_ms;         // 0 = a single pass, the result is the fastest pass
+    uint32_t min_cspeed;       // skip codecs that compress 100 KB slower than this many MB/s, 0 = none
+    int compress_only;
+} lzbench_bench_options_t;
+
+#define LZBENCH_NAME_SIZE 256  // of the strings of lzbench_result_t, including the terminating zero
+
+typedef struct
+{
+    char name[LZBENCH_NAME_SIZE];     // "zstd 1.4.8 -3" as in the lzbench output
+    char encoder[LZBENCH_NAME_SIZE];  // "zstd,3" for lzbench_bench() and -e
+    uint64_t insize;
+    uint64_t outsize;
+    uint64_t ctime_ns;         // time of compressing the whole input once
+    uint64_t dtime_ns;         // time of decompressing it, 0 if the output didn't match or with compress_only
+    double cspeed;             // MB/s (10^6 bytes) of input
+    double dspeed;
+} lzbench_result_t;
+
+/* number of built-in compressors, lzbench_codec_info() fills info for index 0 to count-1 and returns 0 past it */
+int lzbench_codec_count(void);
+int lzbench_codec_info(int index, lzbench_codec_info_t* info);
+
+/* 100 ms budgets, one chunk */
+void lzbench_bench_defaults(lzbench_bench_options_t* opt);
+
+/* benchmarks the compressors of encoders (the -e syntax: names, levels, key=value parameters and aliases) on
+   a copy of data, writes up to max_results results and returns their total number, -1 without memory or -2 if
+   the name or encoder of a result is longer than LZBENCH_NAME_SIZE - 1 characters */
+int lzbench_bench(const char* encoders, const void* data, size_t size, const lzbench_bench_options_t* opt,
+                  lzbench_result_t* results, size_t max_results);
+
+typedef struct lzbench_session lzbench_session_t;
+
+/* a session with the defaults of the command line, NULL without memory */
+lzbench_session_t* lzbench_session_new(void);
+
+/* applies an option of the command line such as "-o7", "-b1024", "--cache=file" or "--compare=base.json,5"; returns
+   0, 1 after printing why the option is invalid, or -1 if it is not a session option (-h, -l or unknown) */
+int lzbench_session_option(lzbench_session_t* s, const char* option);
+
+/* benchmark the -e list on the input files (one by one, joined with -j, recursively with -r, in parts with -m) or
+   on the data of --gen; return 0, 1 on an error (printed) or -1 without files or --gen */
+int lzbench_session_run(lzbench_session_t* s, const char* const* files, size_t count);
+int lzbench_session_bench(lzbench_session_t* s, const void* data, size_t size, const char* name);  // on a copy of data
+
+/* prints the cache statistics and the --roofline, --compare and -c reports; returns 0, or as --compare 2 for a
+   significant regression and 1 for a row without a match */
+int lzbench_session_finish(lzbench_session_t* s);
+
+/* the rows of all inputs so far, as lzbench_bench() */
+int lzbench_session_results(lzbench_session_t* s, lzbench_result_t* results, size_t max_results);
+
+void lzbench_session_free(lzbench_session_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
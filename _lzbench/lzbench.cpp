@@ -20,10 +20,30 @@
 #include "util.h"
 #include <numeric>
 #include <algorithm> // sort
+#include <mutex>
+#include <new>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
+#include <errno.h>
+#include <math.h> // log2
+#ifndef BENCH_REMOVE_LZ4
+    #include "lz4/lz4.h"     // LZ4_stream_t of the --estimate=lz4 probe
+#endif
+
+#if defined(__linux__)
+    #include <sys/mman.h>    // mmap, madvise
+    #include <sys/syscall.h> // SYS_mbind
+    #define LZBENCH_HAS_MMAP
+    #ifndef MPOL_BIND
+        #define MPOL_BIND 2
+        #define MPOL_INTERLEAVE 3
+    #endif
+#endif
+
+
+std::mutex global_state_lock;  // held while a codec with LZBENCH_PLUGIN_NO_THREADS runs
 
 
 int istrcmp(const char *str1, const char *str2)
@@ -69,15 +89,78 @@ std::vector<std::string> split(const std::string &text, char sep)
 }
 
 
+/* a number with an optional K, M or G suffix (powers of 1024) */
+uint64_t parse_size(const char *str, const char **end)
+{
+    char *p;
+    uint64_t size = strtoull(str, &p, 10);
+
+    switch (*p)
+    {
+        case 'k': case 'K': size <<= 10; p++; break;
+        case 'm': case 'M': size <<= 20; p++; break;
+        case 'g': case 'G': size <<= 30; p++; break;
+    }
+    if (end) *end = p;
+    return size;
+}
+
+
+std::vector<compressor_desc_t> plugin_codecs;
+std::vector<alias_desc_t> plugin_aliases;
+
+/* the built-in or plugin compressor called name, NULL if there is none */
+const compressor_desc_t* find_compressor(const char* name)
+{
+    for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
+        if (istrcmp(comp_desc[i].name, name) == 0) return &comp_desc[i];
+    for (size_t i=0; i<plugin_codecs.size(); i++)
+        if (istrcmp(plugin_codecs[i].name, name) == 0) return &plugin_codecs[i];
+    return NULL;
+}
+
+
+/* --plugin=path, the codecs are copied as they are, so the timed loops call the plugin functions directly */
+bool plugin_add(const char* path)
+{
+    const lzbench_plugin_t* plugin = plugin_load(path);
+
+    if (!plugin) return false;
+    for (uint32_t i=0; i<plugin->codec_count; i++)
+    {
+        const lzbench_plugin_codec_t* c = &plugin->codecs[i];
+        compressor_desc_t desc = { c->name, c->version, c->first_level, c->last_level, c->additional_param, c->max_block_size,
+            c->compress, c->decompress, c->init, c->deinit, c->keys, c->flags };
+
+        if (!c->name || !c->name[0] || strpbrk(c->name, ",/=") || !c->compress || !c->decompress || c->first_level > c->last_level)
+        {
+            fprintf(stderr, "%s: invalid compressor %s\n", path, c->name ? c->name : "(null)");
+            return false;
+        }
+        if (find_compressor(c->name)) { fprintf(stderr, "%s: compressor %s already exists\n", path, c->name); return false; }
+        if (!desc.version) desc.version = "";
+        plugin_codecs.push_back(desc);
+    }
+    for (uint32_t i=0; i<plugin->alias_count; i++)
+    {
+        alias_desc_t alias = { plugin->aliases[i].name, plugin->aliases[i].params };
+        plugin_aliases.push_back(alias);
+    }
+    return true;
+}
+
+
 void print_header(lzbench_params_t *params)
 {
     switch (params->textformat)
     {
         case CSV:
             if (params->show_speed)
-                printf("Compressor name,Compression speed,Decompression speed,Original size,Compressed size,Ratio,Filename\n");
+                printf("Compressor name,Compression speed,Decompression speed,Original size,Compressed size,Ratio,Filename%s\n", params->sweep_min ? ",Block size" : "");
             else
-                printf("Compressor name,Compression time in us,Decompression time in us,Original size,Compressed size,Ratio,Filename\n"); break;
+                printf("Compressor name,Compression time in us,Decompression time in us,Original size,Compressed size,Ratio,Filename%s\n", params->sweep_min ? ",Block size" : ""); break;
+            break;
+        case JSON:
             break;
         case TURBOBENCH:
             printf("  Compressed  Ratio   Cspeed   Dspeed         Compressor name Filename\n"); break;
@@ -97,6 +180,26 @@ void print_header(lzbench_params_t *params)
 }
 
 
+/* one object per line, with both speeds and times */
+void print_json(lzbench_params_t *params, string_table_t& row)
+{
+    std::string name, filename, encoder, csamples, dsamples;
+
+    for (const char* p = row.col1_algname.c_str(); *p; p++) { if (*p == '"' || *p == '\\') name += '\\'; name += *p; }
+    for (const char* p = row.col6_filename.c_str(); *p; p++) { if (*p == '"' || *p == '\\') filename += '\\'; filename += *p; }
+    for (const char* p = row.encoder.c_str(); *p; p++) { if (*p == '"' || *p == '\\') encoder += '\\'; encoder += *p; }
+    for (size_t i=0; i<row.csamples.size(); i++) csamples += (i ? "," : "") + std::to_string((unsigned long long)row.csamples[i]);
+    for (size_t i=0; i<row.dsamples.size(); i++) dsamples += (i ? "," : "") + std::to_string((unsigned long long)row.dsamples[i]);
+
+    printf("{\"compressor\":\"%s\",\"compression_speed\":%.2f,\"decompression_speed\":%.2f,\"compression_time_ns\":%llu,\"decompression_time_ns\":%llu,"
+        "\"original_size\":%llu,\"compressed_size\":%llu,\"ratio\":%.2f,\"block_size\":%llu,\"filename\":\"%s\",\"encoder\":\"%s\","
+        "\"compression_samples_ns\":[%s],\"decompression_samples_ns\":[%s]}\n",
+        name.c_str(), (!row.col2_ctime) ? 0 : (row.col5_origsize * 1000.0 / row.col2_ctime), (!row.col3_dtime) ? 0 : (row.col5_origsize * 1000.0 / row.col3_dtime),
+        (unsigned long long)row.col2_ctime, (unsigned long long)row.col3_dtime, (unsigned long long)row.col5_origsize, (unsigned long long)row.col4_comprsize,
+        (!row.col5_origsize) ? 0 : (row.col4_comprsize * 100.0 / row.col5_origsize), (unsigned long long)row.col7_chunksize, filename.c_str(), encoder.c_str(), csamples.c_str(), dsamples.c_str());
+}
+
+
 void print_speed(lzbench_params_t *params, string_table_t& row)
 {
     float cspeed, dspeed, ratio;
@@ -107,7 +210,11 @@ void print_speed(lzbench_params_t *params, string_table_t& row)
     switch (params->textformat)
     {
         case CSV:
-            printf("%s,%.2f,%.2f,%llu,%llu,%.2f,%s\n", row.col1_algname.c_str(), cspeed, dspeed, (unsigned long long)row.col5_origsize, (unsigned long long)row.col4_comprsize, ratio, row.col6_filename.c_str()); break;
+            printf("%s,%.2f,%.2f,%llu,%llu,%.2f,%s", row.col1_algname.c_str(), cspeed, dspeed, (unsigned long long)row.col5_origsize, (unsigned long long)row.col4_comprsize, ratio, row.col6_filename.c_str());
+            if (params->sweep_min) printf(",%llu", (unsigned long long)row.col7_chunksize);
+            printf("\n"); break;
+        case JSON:
+            print_json(params, row); break;
         case TURBOBENCH:
             printf("%12llu %6.1f%9.2f%9.2f  %22s %s\n", (unsigned long long)row.col4_comprsize, ratio, cspeed, dspeed, row.col1_algname.c_str(), row.col6_filename.c_str()); break;
         case TEXT:
@@ -155,7 +262,11 @@ void print_time(lzbench_params_t *params, string_table_t& row)
     switch (params->textformat)
     {
         case CSV:
-            printf("%s,%llu,%llu,%llu,%llu,%.2f,%s\n", row.col1_algname.c_str(), (unsigned long long)ctime, (unsigned long long)dtime,  (unsigned long long) row.col5_origsize, (unsigned long long)row.col4_comprsize, ratio, row.col6_filename.c_str()); break; 
+            printf("%s,%llu,%llu,%llu,%llu,%.2f,%s", row.col1_algname.c_str(), (unsigned long long)ctime, (unsigned long long)dtime,  (unsigned long long) row.col5_origsize, (unsigned long long)row.col4_comprsize, ratio, row.col6_filename.c_str());
+            if (params->sweep_min) printf(",%llu", (unsigned long long)row.col7_chunksize);
+            printf("\n"); break;
+        case JSON:
+            print_json(params, row); break;
         case TURBOBENCH:
             printf("%12llu %6.1f%9llu%9llu  %22s %s\n", (unsigned long long)row.col4_comprsize, ratio, (unsigned long long)ctime, (unsigned long long)dtime, row.col1_algname.c_str(), row.col6_filename.c_str()); break;
         case TEXT:
@@ -185,37 +296,57 @@ void print_time(lzbench_params_t *params, string_table_t& row)
 }
 
 
-void print_stats(lzbench_params_t *params, const compressor_desc_t* desc, int level, std::vector<uint64_t> &ctime, std::vector<uint64_t> &dtime, size_t insize, size_t outsize, bool decomp_error)
+/* fastest, average or median time depending on -p */
+uint64_t select_time(lzbench_params_t *params, std::vector<uint64_t> &times)
 {
-    std::string col1_algname;
-    std::sort(ctime.begin(), ctime.end());
-    std::sort(dtime.begin(), dtime.end());
-    uint64_t best_ctime, best_dtime;
-    
+    if (times.empty()) return 0;
+    std::sort(times.begin(), times.end());
+
     switch (params->timetype)
     {
         default:
-        case FASTEST: 
-            best_ctime = ctime.empty()?0:ctime[0];
-            best_dtime = dtime.empty()?0:dtime[0];
-            break;
-        case AVERAGE: 
-            best_ctime = ctime.empty()?0:std::accumulate(ctime.begin(),ctime.end(),(uint64_t)0) / ctime.size();
-            best_dtime = dtime.empty()?0:std::accumulate(dtime.begin(),dtime.end(),(uint64_t)0) / dtime.size();
-            break;
-        case MEDIAN: 
-            best_ctime = ctime.empty()?0:(ctime[(ctime.size()-1)/2] + ctime[ctime.size()/2]) / 2;
-            best_dtime = dtime.empty()?0:(dtime[(dtime.size()-1)/2] + dtime[dtime.size()/2]) / 2;
-            break;
+        case FASTEST:
+            return times[0];
+        case AVERAGE:
+            return std::accumulate(times.begin(), times.end(), (uint64_t)0) / times.size();
+        case MEDIAN:
+            return (times[(times.size()-1)/2] + times[times.size()/2]) / 2;
     }
+}
+
+
+/* ctime and dtime are the times the speeds are selected from, csamples and dsamples the times of each timing loop for --compare */
+void print_stats(lzbench_params_t *params, const compressor_desc_t* desc, int level, std::vector<uint64_t> &ctime, std::vector<uint64_t> &dtime, std::vector<uint64_t> &csamples, std::vector<uint64_t> &dsamples, size_t insize, size_t outsize, size_t chunk_size, bool decomp_error)
+{
+    std::string col1_algname;
+    uint64_t best_ctime = select_time(params, ctime);
+    uint64_t best_dtime = select_time(params, dtime);
 
     if (desc->first_level == 0 && desc->last_level==0)
         format(col1_algname, "%s %s", desc->name, desc->version);
     else
         format(col1_algname, "%s %s -%d", desc->name, desc->version, level);
+    if (desc->keys && desc->additional_param)
+    {
+        // the key=value options, separated by spaces so that the CSV columns stay the same
+        std::string options = (const char*)desc->additional_param;
+        std::replace(options.begin(), options.end(), ',', ' ');
+        col1_algname += " " + options;
+    }
 
-    params->results.push_back(string_table_t(col1_algname, best_ctime, (decomp_error)?0:best_dtime, outsize, insize, params->in_filename));
-    if (params->show_speed)
+    params->results.push_back(string_table_t(col1_algname, best_ctime, (decomp_error)?0:best_dtime, outsize, insize, params->in_filename, chunk_size));
+    params->results.back().csamples = csamples;
+    if (!decomp_error) params->results.back().dsamples = dsamples;
+    if (desc->first_level == 0 && desc->last_level==0)
+        params->results.back().encoder = desc->name;
+    else
+        format(params->results.back().encoder, "%s,%d", desc->name, level);
+    if (desc->keys && desc->additional_param)
+        params->results.back().encoder += std::string(",") + (const char*)desc->additional_param;
+
+    if (params->quiet)
+        ;
+    else if (params->show_speed)
         print_speed(params, params->results[params->results.size()-1]);
     else
         print_time(params, params->results[params->results.size()-1]);
@@ -235,13 +366,112 @@ size_t common(uint8_t *p1, uint8_t *p2)
     return size;
 }
 
+#ifdef LZBENCH_HAS_MMAP
+/* the default huge page size of the system (the Hugepagesize line of /proc/meminfo), the one of MAP_HUGETLB */
+size_t huge_page_size()
+{
+    size_t page_size = HUGE_PAGE_SIZE;
+    char line[128];
+    unsigned long kb;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (!f) return page_size;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1)
+        {
+            if (kb && !(kb & (kb - 1))) page_size = (size_t)kb << 10;
+            break;
+        }
+    fclose(f);
+    return page_size;
+}
+
+
+/* mmap-ed buffers are rounded up to the huge page size, so they can be backed by huge pages */
+size_t mmap_size(size_t size)
+{
+    static const size_t page_size = huge_page_size();
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+
+/* bitmask of online NUMA nodes as listed in sysfs e.g. "0-1" or "0,2-3" */
+unsigned long numa_online_nodes()
+{
+    char line[256];
+    unsigned long mask = 0;
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+
+    if (!f) return 1;
+    if (fgets(line, sizeof(line), f))
+    {
+        char *p = line;
+        while (*p >= '0' && *p <= '9')
+        {
+            unsigned long first = strtoul(p, &p, 10), last = first;
+            if (*p == '-') last = strtoul(p+1, &p, 10);
+            for (unsigned long n = first; n <= last && n < 8*sizeof(mask); n++)
+                mask |= 1UL << n;
+            if (*p == ',') p++;
+        }
+    }
+    fclose(f);
+    return mask ? mask : 1;
+}
+
+
+int numa_bind_buffer(lzbench_params_t *params, void *buf, size_t size)
+{
+    unsigned long mask;
+    int mode;
+
+    if (params->numa_policy == NUMA_INTERLEAVE)
+    {
+        mask = numa_online_nodes();
+        mode = MPOL_INTERLEAVE;
+    }
+    else
+    {
+        mask = 1UL << params->numa_node;
+        mode = MPOL_BIND;
+    }
+    return syscall(SYS_mbind, buf, size, mode, &mask, 8*sizeof(mask), 0);
+}
+#endif
+
+
 /*
- * Allocate a buffer of size bytes using malloc (or equivalent call returning a buffer
- * that can be passed to free). Touches each page so that the each page is actually
- * physically allocated and mapped into the process.
+ * Allocate a buffer of size bytes using malloc (or mmap if huge pages or NUMA placement
+ * were requested), the buffer has to be released with free_buffer(). Touches each page
+ * so that the each page is actually physically allocated and mapped into the process.
  */
-void *alloc_and_touch(size_t size, bool must_zero) {
-	void *buf = must_zero ? calloc(1, size) : malloc(size);
+void *alloc_and_touch(lzbench_params_t *params, size_t size, bool must_zero) {
+	void *buf;
+#ifdef LZBENCH_HAS_MMAP
+	if (params->huge_pages || params->numa_policy) {
+		size_t map_size = mmap_size(size);
+		buf = MAP_FAILED;
+		if (params->huge_pages == HUGE_TLB) {
+			buf = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (buf == MAP_FAILED) {
+				LZBENCH_PRINT(2, "warning: MAP_HUGETLB failed (%s), using transparent huge pages for this buffer\n", strerror(errno));
+			}
+		}
+		if (buf == MAP_FAILED) {
+			buf = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (buf == MAP_FAILED) return NULL;
+			if (params->huge_pages && madvise(buf, map_size, MADV_HUGEPAGE) != 0)
+				LZBENCH_PRINT(2, "warning: madvise(MADV_HUGEPAGE) failed (%s)\n", strerror(errno));
+		}
+		// the policy must be set before the first touch, anonymous pages are zero-filled anyway
+		if (params->numa_policy && numa_bind_buffer(params, buf, map_size) != 0) {
+			fprintf(stderr, "mbind failed (%s), the buffers can't be placed as --numa asks\n", strerror(errno));
+			munmap(buf, map_size);
+			return NULL;
+		}
+	} else
+#endif
+	buf = must_zero ? calloc(1, size) : malloc(size);
+	if (!buf) return NULL;
 	volatile char zero = 0;
 	for (size_t i = 0; i < size; i += MIN_PAGE_SIZE) {
 		static_cast<char * volatile>(buf)[i] = zero;
@@ -250,6 +480,433 @@ void *alloc_and_touch(size_t size, bool must_zero) {
 }
 
 
+void free_buffer(lzbench_params_t *params, void *buf, size_t size)
+{
+    if (!buf) return;
+#ifdef LZBENCH_HAS_MMAP
+    if (params->huge_pages || params->numa_policy)
+    {
+        munmap(buf, mmap_size(size));
+        return;
+    }
+#endif
+    free(buf);
+}
+
+
+static const char* estimator_names[] = { "none", "entropy", "hist", "lz4" };
+
+
+/* order-0 statistics of up to ESTIMATE_SAMPLE_SIZE bytes taken as 64-byte blocks spread over the chunk */
+size_t estimate_histogram(uint8_t *inbuf, size_t insize, uint32_t *count)
+{
+    size_t blocks, stride, sampled = 0;
+
+    memset(count, 0, 256*sizeof(uint32_t));
+    if (insize <= ESTIMATE_SAMPLE_SIZE)
+    {
+        for (size_t i=0; i<insize; i++) count[inbuf[i]]++;
+        return insize;
+    }
+
+    blocks = ESTIMATE_SAMPLE_SIZE / 64;
+    stride = (insize - 64) / (blocks - 1);
+    for (size_t b=0; b<blocks; b++, sampled += 64)
+    {
+        const uint8_t *p = inbuf + b*stride;
+        for (int i=0; i<64; i++) count[p[i]]++;
+    }
+    return sampled;
+}
+
+
+/* returns the expected compressed size in percent of insize */
+float estimate_ratio(lzbench_params_t *params, uint8_t *inbuf, size_t insize)
+{
+    uint32_t count[256];
+    size_t n;
+    double bits = 0;
+
+    switch (params->estimator)
+    {
+        default:
+        case EST_NONE:
+            return 0;
+        case EST_ENTROPY: // Shannon entropy
+            n = estimate_histogram(inbuf, insize, count);
+            for (int i=0; i<256; i++)
+                if (count[i]) bits -= count[i] * log2((double)count[i] / n);
+            return n ? bits * 100.0 / (8.0 * n) : 0;
+        case EST_HIST: // collision (Renyi order-2) entropy, no log per symbol
+        {
+            uint64_t sumsq = 0;
+            n = estimate_histogram(inbuf, insize, count);
+            for (int i=0; i<256; i++) sumsq += (uint64_t)count[i] * count[i];
+            return sumsq ? log2((double)n * n / sumsq) * 100.0 / 8.0 : 0;
+        }
+        case EST_LZ4:
+        {
+#ifndef BENCH_REMOVE_LZ4
+            char outbuf[GET_COMPRESS_BOUND(ESTIMATE_LZ4_BLOCK)];
+            LZ4_stream_t state;
+            size_t blocks = MIN(4, (insize + ESTIMATE_LZ4_BLOCK - 1) / ESTIMATE_LZ4_BLOCK);
+            size_t stride = (blocks > 1) ? (insize - ESTIMATE_LZ4_BLOCK) / (blocks - 1) : 0;
+            int64_t clen, csum = 0;
+            n = 0;
+            for (size_t b=0; b<blocks; b++)
+            {
+                size_t part = MIN(insize - b*stride, ESTIMATE_LZ4_BLOCK);
+                clen = lzbench_lz4_compress((char*)inbuf + b*stride, part, outbuf, sizeof(outbuf), 0, 0, (char*)&state);
+                csum += (clen > 0) ? clen : (int64_t)part;
+                n += part;
+            }
+            return n ? csum * 100.0 / n : 0;
+#else
+            return 0;
+#endif
+        }
+    }
+}
+
+
+/* runs the estimator and the compressor separately on each chunk to report estimator cost and accuracy */
+void estimate_report(lzbench_params_t *params, const compressor_desc_t* desc, std::vector<size_t>& chunk_sizes, uint8_t *inbuf, uint8_t *outbuf, size_t outsize, size_t param1, size_t param2, char* workmem, bench_rate_t rate)
+{
+    bench_timer_t start_ticks, end_ticks;
+    uint64_t est_time = 0, full_time = 0, bypass_time = 0, nanosec, lost_bytes = 0, insize = 0;
+    int skipped = 0, false_skips = 0, missed = 0, cscount = chunk_sizes.size();
+
+    for (int i=0; i<cscount; i++)
+    {
+        size_t part = chunk_sizes[i];
+        size_t outpart = MIN(GET_COMPRESS_BOUND(part), outsize);
+
+        GetTime(start_ticks);
+        bool skip = estimate_ratio(params, inbuf, part) > params->estimate_threshold;
+        GetTime(end_ticks);
+        est_time += GetDiffTime(rate, start_ticks, end_ticks);
+
+        GetTime(start_ticks);
+        int64_t clen = desc->compress((char*)inbuf, part, (char*)outbuf, outpart, param1, param2, workmem);
+        GetTime(end_ticks);
+        nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+        full_time += nanosec;
+        if (clen <= 0 || clen > (int64_t)part) clen = part;
+
+        bool incompressible = clen * 100.0 > (double)part * params->estimate_threshold;
+        if (skip)
+        {
+            skipped++;
+            if (!incompressible) { false_skips++; lost_bytes += part - clen; }
+            GetTime(start_ticks);
+            memcpy(outbuf, inbuf, part);
+            GetTime(end_ticks);
+            bypass_time += GetDiffTime(rate, start_ticks, end_ticks);
+        }
+        else
+        {
+            if (incompressible) missed++;
+            bypass_time += nanosec;
+        }
+        inbuf += part;
+        insize += part;
+    }
+
+    LZBENCH_PRINT(2, "%s estimator=%s %.0f MB/s, skipped %d/%d chunks, accuracy %.1f%% (%d false skips losing %llu bytes, %d missed), compression speedup %.2fx\n",
+        desc->name, estimator_names[params->estimator], est_time ? insize * 1000.0 / est_time : 0.0, skipped, cscount,
+        cscount ? 100.0 * (cscount - false_skips - missed) / cscount : 0.0, false_skips, (unsigned long long)lost_bytes, missed,
+        (est_time + bypass_time) ? (double)full_time / (est_time + bypass_time) : 0.0);
+}
+
+
+/* prints the non-empty log2 buckets as lo-hi:percent */
+void parse_histogram(std::string& s, const uint64_t* hist, uint64_t total)
+{
+    std::string text;
+    for (int b=0; b<PARSE_BUCKETS; b++)
+    {
+        unsigned long long lo = 1ULL << b, hi = (2ULL << b) - 1;
+        if (!hist[b]) continue;
+        if (lo == hi)
+            format(text, " %llu:%.1f%%", lo, hist[b] * 100.0 / total);
+        else
+            format(text, " %llu-%llu:%.1f%%", lo, hi, hist[b] * 100.0 / total);
+        s += text;
+    }
+}
+
+
+/* the parse of a compress function (of the variant of --isa), the zstd ones with a window log as param2 */
+static const struct { compress_func compress; int parse; } parse_native[] =
+{
+    { lzbench_lz4_compress,      PARSE_LZ4 },
+    { lzbench_lz4fast_compress,  PARSE_LZ4FAST },
+    { lzbench_lz4hc_compress,    PARSE_LZ4HC },
+    { lzbench_zstd_compress,     PARSE_ZSTD },
+    { lzbench_zstd_chk_compress, PARSE_ZSTD },
+    { lzbench_zstd_LDM_compress, PARSE_ZSTD_LDM },
+};
+
+/* literal and match counts of the codec's parse with log2 histograms of match lengths and offsets */
+void parse_report(lzbench_params_t *params, const compressor_desc_t* desc, int level, std::vector<size_t>& chunk_sizes, uint8_t *inbuf, uint8_t *outbuf, size_t outsize)
+{
+    parse_stats_t stats;
+    std::string name, lengths, offsets;
+    int parse = 0;
+
+    for (size_t i=0; i<sizeof(parse_native)/sizeof(parse_native[0]); i++)
+        if (parse_native[i].compress && desc->compress == (compress_func)isa_variant(params->isa, (isa_func_t)parse_native[i].compress))
+            parse = parse_native[i].parse;
+    memset(&stats, 0, sizeof(stats));
+    for (size_t i=0; i<chunk_sizes.size(); inbuf += chunk_sizes[i], i++)
+        if (!parse_stats_add(parse, level, desc->additional_param, inbuf, chunk_sizes[i], outbuf, MIN(GET_COMPRESS_BOUND(chunk_sizes[i]), outsize), &stats))
+        {
+            LZBENCH_PRINT(2, "%s: no parse statistics (--parse-stats supports lz4, lz4fast, lz4hc and zstd)\n", desc->name);
+            return;
+        }
+
+    if (desc->first_level == 0 && desc->last_level == 0)
+        name = desc->name;
+    else
+        format(name, "%s %d", desc->name, level);
+    parse_histogram(lengths, stats.len_hist, stats.matches);
+    parse_histogram(offsets, stats.offset_hist, stats.matches);
+
+    LZBENCH_PRINT(2, "%s parse: %llu literals (%.1f%% of input), %llu matches (%llu with a repeat offset), average length %.2f, average offset %.0f\n",
+        name.c_str(), (unsigned long long)stats.literals, (stats.literals + stats.len_sum) ? stats.literals * 100.0 / (stats.literals + stats.len_sum) : 0.0,
+        (unsigned long long)stats.matches, (unsigned long long)stats.rep_matches,
+        stats.matches ? (double)stats.len_sum / stats.matches : 0.0, stats.matches ? (double)stats.offset_sum / stats.matches : 0.0);
+    if (stats.matches)
+    {
+        LZBENCH_PRINT(2, "%s lengths:%s\n", name.c_str(), lengths.c_str());
+        LZBENCH_PRINT(2, "%s offsets:%s\n", name.c_str(), offsets.c_str());
+    }
+}
+
+
+typedef struct
+{
+    const compressor_desc_t* desc;
+    const uint8_t *orig;
+    uint8_t *comp, *decomp;
+    size_t size, complen, param1, param2;
+    char* workmem;
+    bench_rate_t rate;
+    uint64_t loop_time;     // 0 = decode once
+} adv_decode_t;
+
+typedef struct
+{
+    int64_t decomplen;
+    int equal;
+    uint64_t nanosec;
+} adv_decode_result_t;
+
+/* runs in the child of adv_run_guarded(), the fastest decode of the stream in loop_time */
+void adv_decode(void* arg, void* result)
+{
+    adv_decode_t* a = (adv_decode_t*)arg;
+    adv_decode_result_t* r = (adv_decode_result_t*)result;
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    uint64_t nanosec;
+
+    r->nanosec = UINT64_MAX;
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        r->decomplen = a->desc->decompress((char*)a->comp, a->complen, (char*)a->decomp, a->size, a->param1, a->param2, a->workmem);
+        GetTime(end_ticks);
+        nanosec = GetDiffTime(a->rate, start_ticks, end_ticks);
+        if (nanosec < r->nanosec) r->nanosec = nanosec;
+    }
+    while (GetDiffTime(a->rate, loop_ticks, end_ticks) < a->loop_time);
+    r->equal = (r->decomplen == (int64_t)a->size && memcmp(a->orig, a->decomp, a->size) == 0);
+}
+
+/* decode time of worst-case inputs and of mutated streams of the first chunk against the first chunk itself */
+void adversarial_report(lzbench_params_t *params, const compressor_desc_t* desc, std::vector<size_t>& chunk_sizes, uint8_t *inbuf, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, size_t param1, size_t param2, char* workmem, bench_rate_t rate)
+{
+    size_t size = MIN(chunk_sizes[0], ADVERSARIAL_MAX_SIZE);
+    std::vector<uint8_t> data(size), stream;
+    adv_decode_t a = { desc, inbuf, compbuf, decomp, size, 0, param1, param2, workmem, rate, params->dloop_time };
+    adv_decode_result_t r;
+    adv_status_e status;
+    std::string text, line;
+    double typical, worst = 0;
+    unsigned timeout;
+    int sig;
+
+    int64_t clen = desc->compress((char*)inbuf, size, (char*)compbuf, MIN(GET_COMPRESS_BOUND(size), comprsize), param1, param2, workmem);
+    if (clen <= 0) { LZBENCH_PRINT(2, "%s: --adversarial needs a compressed chunk\n", desc->name); return; }
+    a.complen = clen;
+    status = adv_run_guarded(adv_decode, &a, &r, sizeof(r), ADVERSARIAL_TIMEOUT, &sig);
+    if (status != ADV_OK || !r.equal) { printf("WARNING: %s %s fails to decode its own stream of the input\n", desc->name, desc->version); return; }
+    typical = (double)r.nanosec / size;
+    stream.assign(compbuf, compbuf + clen);
+    timeout = ADVERSARIAL_TIMEOUT + (unsigned)(20 * r.nanosec / 1000000000);
+    format(line, "%s %s worst-case inputs: input %.3f ns/byte", desc->name, desc->version, typical);
+
+    // valid streams of the worst-case inputs, compressed by the codec
+    for (int k=0; k<ADV_INPUT_COUNT; k++)
+    {
+        adv_generate((adv_input_e)k, &data[0], size, k + 1);
+        a.orig = &data[0];
+        clen = desc->compress((char*)&data[0], size, (char*)compbuf, MIN(GET_COMPRESS_BOUND(size), comprsize), param1, param2, workmem);
+        if (clen <= 0) { format(text, ", %s not compressed", adv_input_names[k]); line += text; continue; }
+        a.complen = clen;
+        status = adv_run_guarded(adv_decode, &a, &r, sizeof(r), timeout, &sig);
+        if (status == ADV_CRASHED)
+            printf("WARNING: %s %s crashed (signal %d) decoding its own stream of the %s input\n", desc->name, desc->version, sig, adv_input_names[k]);
+        else if (status == ADV_TIMEOUT)
+            printf("WARNING: %s %s runs away (over %u s) decoding its own stream of the %s input\n", desc->name, desc->version, timeout, adv_input_names[k]);
+        else if (!r.equal)
+            printf("WARNING: %s %s decodes its own stream of the %s input wrong\n", desc->name, desc->version, adv_input_names[k]);
+        if (status != ADV_OK) { format(text, ", %s FAILED", adv_input_names[k]); line += text; continue; }
+        format(text, ", %s %.3f (%.1fx)", adv_input_names[k], (double)r.nanosec / size, r.nanosec / (typical * size));
+        line += text;
+        if (r.nanosec / (typical * size) > worst) worst = r.nanosec / (typical * size);
+    }
+    LZBENCH_PRINT(2, "%s, worst %.1fx\n", line.c_str(), worst);
+
+    // mutated and truncated streams of the input, bounded by the chunk size as output size
+    if (!params->adversarial_trials) return;
+    if (!adv_guard_available()) { LZBENCH_PRINT(2, "%s: mutated streams need fork()\n", desc->name); return; }
+    uint64_t rejected = 0, wrong = 0, decoded = 0, crashed = 0, runaway = 0, worst_ns = 0;
+    std::vector<uint8_t> mutated(stream.size() + PAD_SIZE);  // decoders may read past the end of their input, like of inbuf
+    a.orig = inbuf;
+    a.comp = &mutated[0];
+    a.loop_time = 0;
+    for (int m=0; m<ADV_MUTATION_COUNT; m++)
+    {
+        int timeouts = 0;
+        for (uint32_t t=0; t<params->adversarial_trials && timeouts<3; t++)
+        {
+            a.complen = adv_mutate((adv_mutation_e)m, &stream[0], stream.size(), &mutated[0], ((uint64_t)m << 32) + t + 1);
+            status = adv_run_guarded(adv_decode, &a, &r, sizeof(r), timeout, &sig);
+            if (status == ADV_CRASHED)
+            {
+                if (!crashed) printf("WARNING: %s %s crashed (signal %d) on a %s stream (seed %llu)\n", desc->name, desc->version, sig, adv_mutation_names[m], ((unsigned long long)m << 32) + t + 1);
+                crashed++;
+            }
+            else if (status == ADV_TIMEOUT)
+            {
+                if (!runaway) printf("WARNING: %s %s runs away (over %u s) on a %s stream (seed %llu)\n", desc->name, desc->version, timeout, adv_mutation_names[m], ((unsigned long long)m << 32) + t + 1);
+                runaway++;
+                timeouts++;
+            }
+            else
+            {
+                if (r.equal) decoded++;
+                else if (r.decomplen <= 0 || r.decomplen > (int64_t)size) rejected++;
+                else wrong++;
+                if (r.nanosec > worst_ns) worst_ns = r.nanosec;
+            }
+        }
+    }
+    LZBENCH_PRINT(2, "%s %s mutated streams: %llu rejected, %llu decoded wrong, %llu decoded right, %llu crashed, %llu runaway, slowest %.3f ns/byte (%.1fx input)\n",
+        desc->name, desc->version, (unsigned long long)rejected, (unsigned long long)wrong, (unsigned long long)decoded, (unsigned long long)crashed,
+        (unsigned long long)runaway, (double)worst_ns / size, worst_ns / (typical * size));
+}
+
+
+/* compresses every chunk with each candidate to compare the selector with single codecs */
+void adaptive_report(lzbench_params_t *params, std::vector<size_t>& chunk_sizes, uint8_t *inbuf, uint8_t *outbuf, size_t outsize, int level, char* workmem, bench_rate_t rate)
+{
+    bench_timer_t start_ticks, end_ticks;
+    size_t count = adaptive_candidates_count();
+    std::vector<uint64_t> csize(count, 0), ctime(count, 0), choices(count + 1, 0);
+    uint64_t select_time = 0, adaptive_size = 0, adaptive_time = 0, oracle_size = 0, insize = 0;
+    std::string text;
+
+    if (!workmem || !count) return;
+
+    for (size_t i=0; i<chunk_sizes.size(); i++)
+    {
+        size_t part = chunk_sizes[i];
+        size_t outpart = MIN(GET_COMPRESS_BOUND(part), outsize);
+        uint64_t best = part;
+
+        GetTime(start_ticks);
+        int choice = adaptive_select(workmem, inbuf, part);
+        GetTime(end_ticks);
+        select_time += GetDiffTime(rate, start_ticks, end_ticks);
+        choices[choice + 1]++;
+        if (choice == ADAPTIVE_STORED) adaptive_size += part;
+
+        for (size_t c=0; c<count; c++)
+        {
+            GetTime(start_ticks);
+            int64_t clen = adaptive_compress_with(workmem, c, (char*)inbuf, part, (char*)outbuf, outpart);
+            GetTime(end_ticks);
+            uint64_t nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+            if (clen <= 0 || clen >= part) clen = part;
+            csize[c] += clen;
+            ctime[c] += nanosec;
+            if (clen + 1 < best) best = clen + 1;
+            if (choice == c) { adaptive_size += (clen < part) ? clen + 1 : part; adaptive_time += nanosec; }
+        }
+        oracle_size += best;
+        inbuf += part;
+        insize += part;
+    }
+    adaptive_time += select_time;
+
+    format(text, "stored %llu", (unsigned long long)choices[0]);
+    size_t best_single = 0;
+    for (size_t c=0; c<count; c++)
+    {
+        const adaptive_candidate_t* cand = adaptive_get_candidate(c);
+        std::string item;
+        format(item, ", %s %d %llu", cand->name, cand->level, (unsigned long long)choices[c + 1]);
+        text += item;
+        if (csize[c] < csize[best_single]) best_single = c;
+    }
+
+    const adaptive_candidate_t* cand = adaptive_get_candidate(best_single);
+    LZBENCH_PRINT(2, "adaptive -%d chunks: %s; selector %.1f%% of compression time\n", level, text.c_str(), adaptive_time ? select_time * 100.0 / adaptive_time : 0.0);
+    LZBENCH_PRINT(2, "adaptive -%d %.2f%% at %.0f MB/s, best single %s %d %.2f%% at %.0f MB/s, per-chunk oracle %.2f%%\n", level,
+        adaptive_size * 100.0 / insize, adaptive_time ? insize * 1000.0 / adaptive_time : 0.0, cand->name, cand->level,
+        csize[best_single] * 100.0 / insize, ctime[best_single] ? insize * 1000.0 / ctime[best_single] : 0.0, oracle_size * 100.0 / insize);
+}
+
+
+/* --adaptive=name[,level]/name[,level]... */
+bool parse_adaptive(const char* list)
+{
+    std::vector<std::string> cnames = split(list, '/');
+
+    adaptive_clear_candidates();
+    for (size_t k=0; k<cnames.size(); k++)
+    {
+        std::vector<std::string> cparams = split(cnames[k], ',');
+        const compressor_desc_t* desc = find_compressor(cparams[0].c_str());
+        adaptive_candidate_t cand;
+
+        if (!desc || desc->compress == lzbench_adaptive_compress || desc->max_block_size || cparams.size() > 2) return false;
+
+        cand.name = desc->name;
+        cand.level = (cparams.size() > 1) ? atoi(cparams[1].c_str()) : desc->first_level;
+        cand.param2 = desc->additional_param;
+        cand.compress = desc->compress;
+        cand.decompress = desc->decompress;
+        cand.init = desc->init;
+        cand.deinit = desc->deinit;
+        if (!adaptive_add_candidate(&cand)) return false;
+    }
+    return true;
+}
+
+
+/* sets the global state of the adaptive pseudo-codec to the options of this run, with global_state_lock held */
+bool adaptive_apply(lzbench_params_t *params)
+{
+    adaptive_set_isa(params->isa);
+    adaptive_set_link(params->adaptive_link);
+    return parse_adaptive(params->adaptive_list ? params->adaptive_list : ADAPTIVE_DEFAULT_CANDIDATES);
+}
+
+
 inline int64_t lzbench_compress(lzbench_params_t *params, std::vector<size_t>& chunk_sizes, compress_func compress, std::vector<size_t> &compr_sizes, uint8_t *inbuf, uint8_t *outbuf, size_t outsize, size_t param1, size_t param2, char* workmem)
 {
     int64_t clen;
@@ -258,6 +915,7 @@ inline int64_t lzbench_compress(lzbench_params_t *params, std::vector<size_t>& c
     int cscount = chunk_sizes.size();
 
     compr_sizes.resize(cscount);
+    if (params->linked_run) params->linked_run(workmem);
 
     for (int i=0; i<cscount; i++)
     {
@@ -265,10 +923,14 @@ inline int64_t lzbench_compress(lzbench_params_t *params, std::vector<size_t>& c
         outpart = GET_COMPRESS_BOUND(part);
         if (outpart > outsize) outpart = outsize;
 
-        clen = compress((char*)inbuf, part, (char*)outbuf, outpart, param1, param2, workmem);
+        if (params->estimator && !params->linked_run && estimate_ratio(params, inbuf, part) > params->estimate_threshold)
+            clen = 0; // predicted incompressible, stored uncompressed
+        else
+            clen = compress((char*)inbuf, part, (char*)outbuf, outpart, param1, param2, workmem);
         LZBENCH_PRINT(9, "ENC part=%d clen=%d in=%d\n", (int)part, (int)clen, (int)(inbuf-start));
 
-        if (clen <= 0 || clen == part)
+        if (clen <= 0 && params->linked_run) return 0;  // a stored chunk would not be in the history of the next ones
+        if (clen <= 0 || (clen == part && !params->linked_run))
         {
             if (part > outsize) return 0;
             memcpy(outbuf, inbuf, part);
@@ -292,10 +954,11 @@ inline int64_t lzbench_decompress(lzbench_params_t *params, std::vector<size_t>&
     uint8_t *outstart = outbuf;
     int cscount = compr_sizes.size();
 
+    if (params->linked_run) params->linked_run(workmem);
     for (int i=0; i<cscount; i++)
     {
         part = compr_sizes[i];
-        if (part == chunk_sizes[i]) // uncompressed
+        if (part == chunk_sizes[i] && !params->linked_run) // uncompressed
         {
             memcpy(outbuf, inbuf, part);
             dlen = part;
@@ -316,52 +979,1215 @@ inline int64_t lzbench_decompress(lzbench_params_t *params, std::vector<size_t>&
 }
 
 
-void lzbench_test(lzbench_params_t *params, std::vector<size_t> &file_sizes, const compressor_desc_t* desc, int level, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate, size_t param1)
+typedef struct
 {
-    float speed;
-    int i, total_c_iters, total_d_iters;
-    bench_timer_t loop_ticks, start_ticks, end_ticks, timer_ticks;
-    int64_t complen=0, decomplen;
-    uint64_t nanosec, total_nanosec;
-    std::vector<uint64_t> ctime, dtime;
-    std::vector<size_t> compr_sizes, chunk_sizes;
-    bool decomp_error = false;
-    char* workmem = NULL;
-    size_t param2 = desc->additional_param;
-    size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
-
-    LZBENCH_PRINT(5, "*** trying %s insize=%d comprsize=%d chunk_size=%d\n", desc->name, (int)insize, (int)comprsize, (int)chunk_size);
-
-    if (desc->max_block_size != 0 && chunk_size > desc->max_block_size) chunk_size = desc->max_block_size;
-    if (!desc->compress || !desc->decompress) goto done;
-    if (desc->init) workmem = desc->init(chunk_size, param1, param2);
+    const compressor_desc_t* desc;
+    std::vector<size_t> *chunk_sizes, *compr_sizes;
+    const uint8_t *orig, *comp;
+    uint8_t *buf;
+    size_t insize, complen, margin, param1, param2;
+    char* workmem;
+} inplace_t;
+
+/* decodes the streams packed at the tail of buf[insize + margin] to the start of buf, stored chunks are moved */
+int64_t inplace_decompress(inplace_t* p)
+{
+    uint8_t *in = p->buf + p->insize + p->margin - p->complen, *out = p->buf;
+    int64_t dlen;
 
-    if (params->cspeed > 0)
+    for (size_t i=0; i<p->compr_sizes->size(); i++)
     {
-        size_t part = MIN(100*1024, chunk_size);
-        GetTime(start_ticks);
-        int64_t clen = desc->compress((char*)inbuf, part, (char*)compbuf, GET_COMPRESS_BOUND(part), param1, param2, workmem);
-        GetTime(end_ticks);
-        nanosec = GetDiffTime(rate, start_ticks, end_ticks)/1000;
-        if (clen>0 && nanosec>=1000)
+        size_t part = (*p->compr_sizes)[i];
+        if (part == (*p->chunk_sizes)[i])
+        {
+            memmove(out, in, part);
+            dlen = part;
+        }
+        else
+            dlen = p->desc->decompress((char*)in, part, (char*)out, (*p->chunk_sizes)[i], p->param1, p->param2, p->workmem);
+        if (dlen != (int64_t)(*p->chunk_sizes)[i]) return -1;
+        in += part;
+        out += dlen;
+    }
+    return out - p->buf;
+}
+
+/* runs in the child of adv_run_guarded(), tells if the margin decodes the input */
+void inplace_probe(void* arg, void* result)
+{
+    inplace_t* p = (inplace_t*)arg;
+    memcpy(p->buf + p->insize + p->margin - p->complen, p->comp, p->complen);
+    *(int*)result = inplace_decompress(p) == (int64_t)p->insize && memcmp(p->buf, p->orig, p->insize) == 0;
+}
+
+/* decode time with a single buffer of insize + margin bytes, the smallest margin that decodes and the memory saved */
+void inplace_report(lzbench_params_t *params, const compressor_desc_t* desc, std::vector<size_t>& chunk_sizes, std::vector<size_t>& compr_sizes, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t complen, uint8_t *decomp, size_t param1, size_t param2, char* workmem, bench_rate_t rate)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    std::vector<uint64_t> times, sep_times;
+    std::vector<uint8_t> buffer(insize + complen + PAD_SIZE);
+    inplace_t p = { desc, &chunk_sizes, &compr_sizes, inbuf, compbuf, &buffer[0], insize, complen, complen, param1, param2, workmem };
+    size_t lo = (complen > insize) ? complen - insize : 0, documented = 0;   // the streams start inside the buffer
+    unsigned timeout;
+    int ok, sig;
+
+    if (!(desc->flags & LZBENCH_PLUGIN_INPLACE)) { LZBENCH_PRINT(2, "%s: no in-place decoding\n", desc->name); return; }
+    if (desc->decompress == (compress_func)isa_variant(params->isa, (isa_func_t)lzbench_lz4_decompress))
+        for (size_t i=0; i<compr_sizes.size(); i++)
+            documented = MAX(documented, (compr_sizes[i] >> 8) + 32);  // LZ4_DECOMPRESS_INPLACE_MARGIN
+
+    // separate buffers, timed the same way as in place
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        lzbench_decompress(params, chunk_sizes, desc->decompress, compr_sizes, compbuf, decomp, param1, param2, workmem);
+        GetTime(end_ticks);
+        sep_times.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
+    timeout = ADVERSARIAL_TIMEOUT + (unsigned)(20 * select_time(params, sep_times) / 1000000000);
+
+    // the smallest margin is searched in child processes, as a too small one lets the decoder read its own output
+    if (adv_run_guarded(inplace_probe, &p, &ok, sizeof(ok), timeout, &sig) != ADV_OK || !ok)
+    {
+        printf("WARNING: %s %s does not decode in place\n", desc->name, desc->version);
+        return;
+    }
+    while (lo < p.margin)
+    {
+        size_t hi = p.margin;
+        p.margin = lo + (hi - lo) / 2;
+        if (adv_run_guarded(inplace_probe, &p, &ok, sizeof(ok), timeout, &sig) == ADV_OK && ok)
+            continue;
+        lo = p.margin + 1;
+        p.margin = hi;
+    }
+
+    GetTime(loop_ticks);
+    do
+    {
+        memcpy(p.buf + insize + p.margin - complen, compbuf, complen);
+        GetTime(start_ticks);
+        inplace_decompress(&p);
+        GetTime(end_ticks);
+        times.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
+
+    uint64_t itime = select_time(params, times), stime = select_time(params, sep_times);
+    char doc[32] = "none";
+    if (documented) snprintf(doc, sizeof(doc), "%llu", (unsigned long long)documented);
+    LZBENCH_PRINT(2, "%s %s in place: %.2f MB/s (separate buffers %.2f MB/s), margin %llu bytes (documented %s), peak memory %llu KB instead of %llu KB (%.1f%% saved)\n",
+        desc->name, desc->version, itime ? insize * 1000.0 / itime : 0.0, stime ? insize * 1000.0 / stime : 0.0, (unsigned long long)p.margin, doc,
+        (unsigned long long)((insize + p.margin) >> 10), (unsigned long long)((insize + complen) >> 10), 100.0 * (complen - (double)p.margin) / (insize + complen));
+}
+
+
+typedef struct
+{
+    const compressor_desc_t* desc;
+    const uint8_t *inbuf, *compbuf;
+    uint8_t *decomp, *out;
+    size_t part, outpart, complen, param1, param2;
+    bool decode;
+    bench_rate_t rate;
+} cold_t;
+
+typedef struct
+{
+    int ok;                            // 0 if init returned no context
+    uint64_t init, compress, decompress;
+} cold_trial_t;
+
+/* runs in the child of adv_run_guarded(), so that each trial starts in a process that hasn't run the codec */
+void cold_trial(void* arg, void* result)
+{
+    cold_t* p = (cold_t*)arg;
+    cold_trial_t* r = (cold_trial_t*)result;
+    bench_timer_t start_ticks, end_ticks;
+    char* fresh = NULL;
+
+    memset(r, 0, sizeof(cold_trial_t));
+    GetTime(start_ticks);
+    if (p->desc->init && !(fresh = p->desc->init(p->part, p->param1, p->param2))) return;
+    GetTime(end_ticks);
+    r->init = GetDiffTime(p->rate, start_ticks, end_ticks);
+    GetTime(start_ticks);
+    p->desc->compress((char*)p->inbuf, p->part, (char*)p->out, p->outpart, p->param1, p->param2, fresh);
+    GetTime(end_ticks);
+    r->compress = GetDiffTime(p->rate, start_ticks, end_ticks);
+    if (p->desc->deinit) p->desc->deinit(fresh);
+
+    if (p->decode)
+    {
+        if (p->desc->init && !(fresh = p->desc->init(p->part, p->param1, p->param2))) return;
+        GetTime(start_ticks);
+        p->desc->decompress((char*)p->compbuf, p->complen, (char*)p->decomp, p->part, p->param1, p->param2, fresh);
+        GetTime(end_ticks);
+        r->decompress = GetDiffTime(p->rate, start_ticks, end_ticks);
+        if (p->desc->deinit) p->desc->deinit(fresh);
+    }
+    r->ok = 1;
+}
+
+/* --cold, the time of init, of the first call in a fresh context and of a call in a warm one for the first chunk */
+void cold_report(lzbench_params_t *params, const compressor_desc_t* desc, std::vector<size_t>& chunk_sizes, std::vector<size_t>& compr_sizes, uint8_t *inbuf, uint8_t *compbuf, uint8_t *decomp, size_t param1, size_t param2, char* workmem, bench_rate_t rate)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    std::vector<uint64_t> itime, cfirst, csteady, dfirst, dsteady;
+    size_t part = chunk_sizes[0], outpart = GET_COMPRESS_BOUND(part);
+    bool decode = !params->compress_only && compr_sizes[0] != part;  // stored chunks are not decoded
+    std::vector<uint8_t> out(outpart);
+    cold_t p = { desc, inbuf, compbuf, decomp, &out[0], part, outpart, compr_sizes[0], param1, param2, decode, rate };
+    cold_trial_t r;
+    unsigned timeout;
+    int sig;
+
+    // the context of the timed loops, warmed up by them
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        desc->compress((char*)inbuf, part, (char*)&out[0], outpart, param1, param2, workmem);
+        GetTime(end_ticks);
+        csteady.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+        if (decode)
+        {
+            GetTime(start_ticks);
+            desc->decompress((char*)compbuf, compr_sizes[0], (char*)decomp, part, param1, param2, workmem);
+            GetTime(end_ticks);
+            dsteady.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+        }
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
+    timeout = ADVERSARIAL_TIMEOUT + (unsigned)(20 * (select_time(params, csteady) + select_time(params, dsteady)) / 1000000000);
+
+    // each trial is a new process with a new context, as a process that handles a single payload
+    GetTime(loop_ticks);
+    do
+    {
+        adv_status_e status = adv_run_guarded(cold_trial, &p, &r, sizeof(r), timeout, &sig);
+        GetTime(end_ticks);
+        if (status != ADV_OK) { printf("WARNING: %s %s cold: the trial %s\n", desc->name, desc->version, (status == ADV_TIMEOUT) ? "timed out" : "crashed"); return; }
+        if (!r.ok) { LZBENCH_PRINT(2, "%s %s cold: init failed, skipped\n", desc->name, desc->version); return; }
+        itime.push_back(r.init);
+        cfirst.push_back(r.compress);
+        if (decode) dfirst.push_back(r.decompress);
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
+
+    LZBENCH_PRINT(2, "%s %s cold (%llu bytes, %u trials): init %.1f us, compress first %.1f us steady %.1f us", desc->name, desc->version, (unsigned long long)part,
+        (unsigned)itime.size(), select_time(params, itime) / 1000.0, select_time(params, cfirst) / 1000.0, select_time(params, csteady) / 1000.0);
+    if (decode)
+        LZBENCH_PRINT(2, ", decompress first %.1f us steady %.1f us", select_time(params, dfirst) / 1000.0, select_time(params, dsteady) / 1000.0);
+    LZBENCH_PRINT(2, "%s\n", "");
+}
+
+
+/* the codecs that allocate their state in each call, with functions that keep it in a context per stream for --streams */
+static const struct { compress_func plain; compress_func compress; compress_func decompress; init_func init; deinit_func deinit; } streams_native[] =
+{
+    { lzbench_zlib_compress,   lzbench_zlib_stream_compress,   lzbench_zlib_stream_decompress,   lzbench_zlib_stream_init,   lzbench_zlib_stream_deinit },
+    { lzbench_brotli_compress, lzbench_brotli_stream_compress, lzbench_brotli_stream_decompress, lzbench_brotli_stream_init, lzbench_brotli_stream_deinit },
+};
+
+/* --streams, the speed of sending the chunks round-robin to K contexts and the memory of the contexts, for each K */
+void streams_report(lzbench_params_t *params, const compressor_desc_t* desc, std::vector<size_t>& chunk_sizes, std::vector<size_t>& compr_sizes, uint8_t *inbuf, uint8_t *compbuf, uint8_t *decomp, size_t param1, size_t param2, bench_rate_t rate)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    std::vector<unsigned> counts;
+    std::vector<size_t> in_offsets, comp_offsets;
+    size_t max_chunk = 0, in_pos = 0, comp_pos = 0;
+    compressor_desc_t stream = *desc;
+
+    for (size_t i=0; i<sizeof(streams_native)/sizeof(streams_native[0]); i++)
+        if (streams_native[i].compress && desc->compress == (compress_func)isa_variant(params->isa, (isa_func_t)streams_native[i].plain))
+        {
+            // desc is already the variant of --isa
+            stream.compress = (compress_func)isa_variant(params->isa, (isa_func_t)streams_native[i].compress);
+            stream.decompress = (compress_func)isa_variant(params->isa, (isa_func_t)streams_native[i].decompress);
+            stream.init = (init_func)isa_variant(params->isa, (isa_func_t)streams_native[i].init);
+            stream.deinit = (deinit_func)isa_variant(params->isa, (isa_func_t)streams_native[i].deinit);
+        }
+    desc = &stream;
+    if (!desc->init) { LZBENCH_PRINT(2, "%s %s streams: no context, the state is created in each call\n", desc->name, desc->version); return; }
+    streams_parse(params->streams, counts);
+    for (size_t c=0; c<chunk_sizes.size(); c++)
+    {
+        in_offsets.push_back(in_pos);
+        comp_offsets.push_back(comp_pos);
+        in_pos += chunk_sizes[c];
+        comp_pos += compr_sizes[c];
+        max_chunk = MAX(max_chunk, chunk_sizes[c]);
+    }
+    std::vector<uint8_t> out(GET_COMPRESS_BOUND(max_chunk));
+
+    for (size_t k=0; k<counts.size(); k++)
+    {
+        std::vector<char*> contexts;
+        std::vector<uint64_t> ctime, dtime;
+        size_t calls = MAX(counts[k], chunk_sizes.size()), bytes = 0, allocated = streams_allocated_memory();
+        bool failed = false;
+
+        for (unsigned i=0; i<counts[k] && !failed; i++)
+        {
+            contexts.push_back(desc->init(max_chunk, param1, param2));
+            failed = !contexts.back();
+        }
+        for (size_t j=0; j<calls; j++) bytes += chunk_sizes[j % chunk_sizes.size()];
+
+        // call j sends chunk j % chunks to context j % K, so every context is used in each pass
+        do
+        {
+            if (failed) break;
+            GetTime(loop_ticks);
+            do
+            {
+                GetTime(start_ticks);
+                for (size_t j=0; j<calls; j++)
+                {
+                    size_t c = j % chunk_sizes.size();
+                    desc->compress((char*)inbuf + in_offsets[c], chunk_sizes[c], (char*)&out[0], out.size(), param1, param2, contexts[j % counts[k]]);
+                }
+                GetTime(end_ticks);
+                ctime.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+            }
+            while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
+
+            if (params->compress_only) break;
+            GetTime(loop_ticks);
+            do
+            {
+                GetTime(start_ticks);
+                for (size_t j=0; j<calls; j++)
+                {
+                    size_t c = j % chunk_sizes.size();
+                    if (compr_sizes[c] == chunk_sizes[c]) // stored
+                        memcpy(decomp + in_offsets[c], compbuf + comp_offsets[c], chunk_sizes[c]);
+                    else
+                        desc->decompress((char*)compbuf + comp_offsets[c], compr_sizes[c], (char*)decomp + in_offsets[c], chunk_sizes[c], param1, param2, contexts[j % counts[k]]);
+                }
+                GetTime(end_ticks);
+                dtime.push_back(GetDiffTime(rate, start_ticks, end_ticks));
+            }
+            while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
+        }
+        while (false);
+
+        size_t used = streams_allocated_memory();
+        used = (used > allocated) ? used - allocated : 0;
+        for (size_t i=0; i<contexts.size(); i++)
+            if (desc->deinit) desc->deinit(contexts[i]);
+
+        if (failed) { LZBENCH_PRINT(2, "%s %s streams=%u: out of memory\n", desc->name, desc->version, counts[k]); break; }
+        uint64_t ct = select_time(params, ctime), dt = select_time(params, dtime);
+        LZBENCH_PRINT(2, "%s %s streams=%u: compress %.2f MB/s", desc->name, desc->version, counts[k], ct ? bytes * 1000.0 / ct : 0.0);
+        if (!params->compress_only)
+            LZBENCH_PRINT(2, ", decompress %.2f MB/s", dt ? bytes * 1000.0 / dt : 0.0);
+        LZBENCH_PRINT(2, ", contexts %llu KB (%llu bytes each)\n", (unsigned long long)(used >> 10), (unsigned long long)(used / counts[k]));
+    }
+    memset(decomp, 0, in_pos);
+}
+
+
+typedef struct
+{
+    std::vector<uint64_t> latency;     // from the arrival (open loop) or the start (closed loop) to the end of a request
+    uint64_t requests, bytes, busy;    // busy is the time spent in the codec
+} workload_stats_t;
+
+/* runs passes over the requests for the loop time, each request as a single chunk of lzbench_compress/lzbench_decompress */
+uint64_t workload_run(lzbench_params_t *params, const compressor_desc_t* desc, bool decode, std::vector<size_t>& sizes, std::vector<size_t>& offsets,
+    std::vector<uint64_t>& arrivals, uint8_t *inbuf, std::vector<uint8_t>& store, std::vector<size_t>& comp_offsets, std::vector<size_t>& comp_sizes,
+    uint8_t *outbuf, size_t outsize, size_t param1, size_t param2, char* workmem, bench_rate_t rate, workload_stats_t* stats)
+{
+    bench_timer_t loop_ticks, pass_ticks, start_ticks, end_ticks;
+    std::vector<size_t> chunk(1), csize(1);
+    uint32_t loop_time = decode ? params->dloop_time : params->cloop_time;
+    bool first = true;  // the first pass keeps the compressed requests or verifies the decoded ones
+
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(pass_ticks);
+        for (size_t i=0; i<sizes.size(); i++)
+        {
+            chunk[0] = sizes[i];
+            if (arrivals[i]) // open loop: wait for the arrival, a late start counts in the latency
+                do { GetTime(start_ticks); } while (GetDiffTime(rate, pass_ticks, start_ticks) < arrivals[i]);
+            else
+                GetTime(start_ticks);
+            if (decode)
+            {
+                csize[0] = comp_sizes[i];
+                lzbench_decompress(params, chunk, desc->decompress, csize, &store[comp_offsets[i]], outbuf, param1, param2, workmem);
+            }
+            else
+                lzbench_compress(params, chunk, desc->compress, csize, inbuf + offsets[i], outbuf, outsize, param1, param2, workmem);
+            GetTime(end_ticks);
+
+            workload_stats_t& b = stats[workload_bucket(sizes[i])];
+            uint64_t busy = GetDiffTime(rate, start_ticks, end_ticks);
+            b.latency.push_back(arrivals[i] ? GetDiffTime(rate, pass_ticks, end_ticks) - arrivals[i] : busy);
+            b.requests++;
+            b.bytes += sizes[i];
+            b.busy += busy;
+
+            if (first && !decode)
+            {
+                comp_offsets[i] = store.size();
+                comp_sizes[i] = csize[0];
+                store.insert(store.end(), outbuf, outbuf + csize[0]);
+            }
+            if (first && decode && memcmp(outbuf, inbuf + offsets[i], sizes[i]))
+                return 0;
+        }
+        first = false;
+        GetTime(end_ticks);
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < loop_time);
+
+    return GetDiffTime(rate, loop_ticks, end_ticks);
+}
+
+
+/* --workload, throughput and latency percentiles of variable-sized requests per size bucket */
+void workload_report(lzbench_params_t *params, const compressor_desc_t* desc, uint8_t *inbuf, size_t insize, uint8_t *decomp, size_t param1, size_t param2, char* workmem, bench_rate_t rate)
+{
+    workload_t w;
+    std::vector<size_t> sizes, offsets, comp_offsets, comp_sizes;
+    std::vector<uint64_t> arrivals;
+    std::vector<uint8_t> store;
+    workload_stats_t cstats[WORKLOAD_BUCKETS + 1], dstats[WORKLOAD_BUCKETS + 1];
+    size_t pos = 0, max_size = 0;
+    uint64_t cwall, dwall = 0;
+    std::string line;
+
+    workload_parse(params->workload, &w);
+    workload_sizes(&w, insize, sizes);
+    workload_arrivals(&w, sizes.size(), arrivals);
+    for (size_t i=0; i<sizes.size(); i++)
+    {
+        if (pos + sizes[i] > insize) pos = 0;
+        offsets.push_back(pos);
+        pos += sizes[i];
+        max_size = MAX(max_size, sizes[i]);
+    }
+    for (int b=0; b<=WORKLOAD_BUCKETS; b++)
+    {
+        cstats[b].requests = cstats[b].bytes = cstats[b].busy = 0;
+        dstats[b].requests = dstats[b].bytes = dstats[b].busy = 0;
+    }
+    std::vector<uint8_t> out(GET_COMPRESS_BOUND(max_size));
+    comp_offsets.resize(sizes.size());
+    comp_sizes.resize(sizes.size());
+
+    cwall = workload_run(params, desc, false, sizes, offsets, arrivals, inbuf, store, comp_offsets, comp_sizes, &out[0], out.size(), param1, param2, workmem, rate, cstats);
+    if (!params->compress_only)
+    {
+        dwall = workload_run(params, desc, true, sizes, offsets, arrivals, inbuf, store, comp_offsets, comp_sizes, decomp, insize, param1, param2, workmem, rate, dstats);
+        memset(decomp, 0, insize);
+        if (!dwall) { LZBENCH_PRINT(2, "%s %s workload: ERROR, a request does not decode\n", desc->name, desc->version); return; }
+    }
+    for (int b=0; b<WORKLOAD_BUCKETS; b++)
+    {
+        workload_stats_t* all[2] = { &cstats[WORKLOAD_BUCKETS], &dstats[WORKLOAD_BUCKETS] };
+        workload_stats_t* one[2] = { &cstats[b], &dstats[b] };
+        for (int k=0; k<2; k++)
+        {
+            all[k]->latency.insert(all[k]->latency.end(), one[k]->latency.begin(), one[k]->latency.end());
+            all[k]->requests += one[k]->requests;
+            all[k]->bytes += one[k]->bytes;
+            all[k]->busy += one[k]->busy;
+        }
+    }
+
+    if (w.rate > 0) format(line, "open loop at %.0f requests/s", w.rate);
+    else line = "closed loop";
+    LZBENCH_PRINT(2, "%s %s workload (%u requests of %s, %s): compression %.2f MB/s %.0f requests/s", desc->name, desc->version, (unsigned)sizes.size(),
+        w.hist_file.empty() ? "lognormal sizes" : w.hist_file.c_str(), line.c_str(), cstats[WORKLOAD_BUCKETS].bytes * 1000.0 / cwall,
+        cstats[WORKLOAD_BUCKETS].requests * 1e9 / cwall);
+    if (dwall)
+        LZBENCH_PRINT(2, ", decompression %.2f MB/s %.0f requests/s", dstats[WORKLOAD_BUCKETS].bytes * 1000.0 / dwall, dstats[WORKLOAD_BUCKETS].requests * 1e9 / dwall);
+    LZBENCH_PRINT(2, "\n%-12s %8s %13s %9s %9s %9s", "Size", "Requests", "Compress.", "p50 us", "p99 us", "p99.9 us");
+    if (dwall)
+        LZBENCH_PRINT(2, " %13s %9s %9s %9s", "Decompress.", "p50 us", "p99 us", "p99.9 us");
+    LZBENCH_PRINT(2, "%s\n", "");
+    for (int b=0; b<=WORKLOAD_BUCKETS; b++)
+    {
+        workload_stats_t* st[2] = { &cstats[b], &dstats[b] };
+        if (!cstats[b].requests) continue;
+        LZBENCH_PRINT(2, "%-12s %8llu", (b < WORKLOAD_BUCKETS) ? workload_bucket_names[b] : "all", (unsigned long long)cstats[b].requests);
+        for (int k=0; k<(dwall ? 2 : 1); k++)
+        {
+            std::sort(st[k]->latency.begin(), st[k]->latency.end());
+            LZBENCH_PRINT(2, " %8.2f MB/s %9.1f %9.1f %9.1f", st[k]->busy ? st[k]->bytes * 1000.0 / st[k]->busy : 0.0, workload_percentile(st[k]->latency, 50) / 1000.0,
+                workload_percentile(st[k]->latency, 99) / 1000.0, workload_percentile(st[k]->latency, 99.9) / 1000.0);
+        }
+        LZBENCH_PRINT(2, "%s\n", "");
+    }
+}
+
+
+/* true if a codec run prints more than its row, which a cached row can't replace */
+bool has_extra_reports(const lzbench_params_t *params)
+{
+    return params->estimator || params->parse_stats || params->adversarial || params->inplace || params->cold || params->streams || params->workload;
+}
+
+
+/* the parameters of the memcpy row: the default loop times and none of the extra reports */
+void memcpy_baseline_params(const lzbench_params_t *params, lzbench_params_t *params_memcpy)
+{
+    memcpy(params_memcpy, params, sizeof(lzbench_params_t));
+    params_memcpy->cmintime = params_memcpy->dmintime = 0;
+    params_memcpy->c_iters = params_memcpy->d_iters = 0;
+    params_memcpy->cloop_time = params_memcpy->dloop_time = DEFAULT_LOOP_TIME;
+    params_memcpy->estimator = EST_NONE;
+    params_memcpy->parse_stats = 0;
+    params_memcpy->adversarial = 0;
+    params_memcpy->inplace = 0;
+    params_memcpy->cold = 0;
+    params_memcpy->streams = NULL;
+    params_memcpy->workload = NULL;
+}
+
+
+void lzbench_test(lzbench_params_t *params, std::vector<size_t> &file_sizes, const compressor_desc_t* desc, int level, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate, size_t param1)
+{
+    float speed;
+    int i, total_c_iters, total_d_iters;
+    bench_timer_t loop_ticks, start_ticks, end_ticks, timer_ticks;
+    int64_t complen=0, decomplen;
+    uint64_t nanosec, total_nanosec;
+    std::vector<uint64_t> ctime, dtime, cloops, dloops;  // the loop averages are the samples of --compare
+    std::vector<size_t> compr_sizes, chunk_sizes;
+    bool decomp_error = false;
+    char* workmem = NULL;
+    size_t param2 = desc->additional_param;
+    size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
+    compressor_desc_t isa_desc;
+    std::string isa_version, cache_key_str;
+    std::unique_lock<std::mutex> lock(global_state_lock, std::defer_lock);
+
+    if (desc->flags & LZBENCH_PLUGIN_NO_THREADS) lock.lock();
+    if (isa_has_variant((isa_func_t)desc->compress))
+    {
+        isa_desc = *desc;
+        isa_desc.compress = (compress_func)isa_variant(params->isa, (isa_func_t)desc->compress);
+        isa_desc.decompress = (compress_func)isa_variant(params->isa, (isa_func_t)desc->decompress);
+        isa_desc.init = (init_func)isa_variant(params->isa, (isa_func_t)desc->init);
+        isa_desc.deinit = (deinit_func)isa_variant(params->isa, (isa_func_t)desc->deinit);
+        if (params->isa_list)
+        {
+            format(isa_version, "%s %s", desc->version, isa_names[params->isa]);
+            isa_desc.version = isa_version.c_str();
+        }
+        desc = &isa_desc;
+    }
+    if (desc->compress == lzbench_adaptive_compress && !adaptive_apply(params)) goto done;
+
+    LZBENCH_PRINT(5, "*** trying %s insize=%d comprsize=%d chunk_size=%d\n", desc->name, (int)insize, (int)comprsize, (int)chunk_size);
+
+    if (desc->max_block_size != 0 && chunk_size > desc->max_block_size) chunk_size = desc->max_block_size;
+    if (!desc->compress || !desc->decompress) goto done;
+    if (params->cache && desc != &comp_desc[0] && !params->compress_only && !has_extra_reports(params)) // memcpy stays the baseline of this run
+    {
+        cache_entry_t e;
+        std::string cparams = desc->keys ? (desc->additional_param ? (const char*)desc->additional_param : "") : std::to_string((unsigned long long)param2);
+
+        if (desc->compress == lzbench_adaptive_compress) // the result depends on --adaptive and --adaptive-link
+        {
+            for (size_t i=0; i<adaptive_candidates_count(); i++)
+            {
+                const adaptive_candidate_t* c = adaptive_get_candidate(i);
+                cparams += std::string(i ? "/" : " ") + c->name + "," + std::to_string(c->level) + "," + std::to_string((unsigned long long)c->param2);
+            }
+            cparams += " link=" + std::to_string(adaptive_get_link());
+        }
+        cache_key_str = cache_key(params->cache, params->input_hash, file_sizes.size(), desc->name, desc->version, level, cparams, chunk_size);
+        if (cache_find(params->cache, cache_key_str, &e))
+        {
+            if (params->cspeed > 0 && e.ctime && e.origsize * 1000 / e.ctime < params->cspeed) return;
+            ctime.push_back(e.ctime);
+            dtime.push_back(e.dtime);
+            print_stats(params, desc, level, ctime, dtime, ctime, dtime, e.origsize, e.comprsize, chunk_size, !e.dtime);
+            return;
+        }
+    }
+    if (desc->init) workmem = desc->init(chunk_size, param1, param2);
+    if (!workmem && desc->keys) goto done; // rejected key=value parameters
+
+    if (params->cspeed > 0)
+    {
+        size_t part = MIN(100*1024, chunk_size);
+        GetTime(start_ticks);
+        int64_t clen = desc->compress((char*)inbuf, part, (char*)compbuf, GET_COMPRESS_BOUND(part), param1, param2, workmem);
+        GetTime(end_ticks);
+        nanosec = GetDiffTime(rate, start_ticks, end_ticks)/1000;
+        if (clen>0 && nanosec>=1000)
         {
             part = (part / nanosec); // speed in MB/s
             if (part < params->cspeed) { LZBENCH_PRINT(7, "%s (100K) slower than %d MB/s nanosec=%d\n", desc->name, (uint32_t)part, (uint32_t)nanosec); goto done; }
         }
     }
 
-    for (int i=0; i<file_sizes.size(); i++) {
-        size_t tmpsize = file_sizes[i];
-        while (tmpsize > 0)
+    for (int i=0; i<file_sizes.size(); i++) {
+        size_t tmpsize = file_sizes[i];
+        while (tmpsize > 0)
+        {
+            chunk_sizes.push_back(MIN(tmpsize, chunk_size));
+            tmpsize -= MIN(tmpsize, chunk_size);
+        }
+    }
+    
+    LZBENCH_PRINT(5, "%s chunk_sizes=%d\n", desc->name, (int)chunk_sizes.size());
+
+    if (params->estimator)
+        estimate_report(params, desc, chunk_sizes, inbuf, compbuf, comprsize, param1, param2, workmem, rate);
+
+    if (params->parse_stats)
+        parse_report(params, desc, level, chunk_sizes, inbuf, compbuf, comprsize);
+
+    if (params->adversarial && !(desc->flags & LZBENCH_PLUGIN_NO_ADVERSARIAL))
+        adversarial_report(params, desc, chunk_sizes, inbuf, compbuf, comprsize, decomp, param1, param2, workmem, rate);
+
+    if (desc->compress == lzbench_adaptive_compress)
+        adaptive_report(params, chunk_sizes, inbuf, compbuf, comprsize, level, workmem, rate);
+
+    total_c_iters = 0;
+    GetTime(timer_ticks);
+    do
+    {
+        i = 0;
+        uni_sleep(1); // give processor to other processes
+        GetTime(loop_ticks);
+        do
+        {
+            GetTime(start_ticks);
+            complen = lzbench_compress(params, chunk_sizes, desc->compress, compr_sizes, inbuf, compbuf, comprsize, param1, param2, workmem);
+            GetTime(end_ticks);
+            nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+            if (nanosec >= 10000) ctime.push_back(nanosec);
+            i++;
+        }
+        while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
+
+        nanosec = GetDiffTime(rate, loop_ticks, end_ticks);
+        ctime.push_back(nanosec/i);
+        cloops.push_back(nanosec/i);
+        speed = (float)insize*i*1000/nanosec;
+        LZBENCH_PRINT(8, "%s nanosec=%d\n", desc->name, (int)nanosec);
+
+        if ((uint32_t)speed < params->cspeed) { LZBENCH_PRINT(7, "%s slower than %d MB/s\n", desc->name, (uint32_t)speed); goto done; }
+
+        total_nanosec = GetDiffTime(rate, timer_ticks, end_ticks);
+        total_c_iters += i;
+        if ((total_c_iters >= params->c_iters) && (total_nanosec > ((uint64_t)params->cmintime*1000000))) break;
+        LZBENCH_PRINT(2, "%s compr iter=%d time=%.2fs speed=%.2f MB/s     \r", desc->name, total_c_iters, total_nanosec/1000000000.0, speed);
+    }
+    while (true);
+
+
+    total_d_iters = 0;
+    GetTime(timer_ticks);
+    if (!params->compress_only)
+    do
+    {
+        i = 0;
+        uni_sleep(1); // give processor to other processes
+        GetTime(loop_ticks);
+        do
+        {
+            GetTime(start_ticks);
+            decomplen = lzbench_decompress(params, chunk_sizes, desc->decompress, compr_sizes, compbuf, decomp, param1, param2, workmem);
+            GetTime(end_ticks);
+            nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+            if (nanosec >= 10000) dtime.push_back(nanosec);
+            i++;
+        }
+        while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
+
+        nanosec = GetDiffTime(rate, loop_ticks, end_ticks);
+        dtime.push_back(nanosec/i);
+        dloops.push_back(nanosec/i);
+        LZBENCH_PRINT(9, "%s dnanosec=%d\n", desc->name, (int)nanosec);
+
+        if (insize != decomplen)
+        {   
+            decomp_error = true;
+            LZBENCH_PRINT(5, "ERROR: inlen[%d] != outlen[%d]\n", (int32_t)insize, (int32_t)decomplen);
+        }
+        
+        if (memcmp(inbuf, decomp, insize) != 0)
+        {
+            decomp_error = true;
+
+            size_t cmn = common(inbuf, decomp);
+            LZBENCH_PRINT(5, "ERROR in %s: common=%d/%d\n", desc->name, (int32_t)cmn, (int32_t)insize);
+            
+            if (params->verbose >= 10)
+            {
+                char text[256];
+                snprintf(text, sizeof(text), "%s_failed", desc->name);
+                cmn /= chunk_size;
+                size_t err_size = MIN(insize, (cmn+1)*chunk_size);
+                err_size -= cmn*chunk_size;
+                printf("ERROR: fwrite %d-%d to %s\n", (int32_t)(cmn*chunk_size), (int32_t)(cmn*chunk_size+err_size), text);
+                FILE *f = fopen(text, "wb");
+                if (f) fwrite(inbuf+cmn*chunk_size, 1, err_size, f), fclose(f);
+                exit(1);
+            }
+        }
+
+        memset(decomp, 0, insize); // clear output buffer
+
+        if (decomp_error) break;
+        
+        total_nanosec = GetDiffTime(rate, timer_ticks, end_ticks);
+        total_d_iters += i;
+        if ((total_d_iters >= params->d_iters) && (total_nanosec > ((uint64_t)params->dmintime*1000000))) break;
+        LZBENCH_PRINT(2, "%s decompr iter=%d time=%.2fs speed=%.2f MB/s     \r", desc->name, total_d_iters, total_nanosec/1000000000.0, (float)insize*i*1000/nanosec);
+    }
+    while (true);
+
+    if (params->inplace && !params->compress_only && !decomp_error && complen > 0)
+        inplace_report(params, desc, chunk_sizes, compr_sizes, inbuf, insize, compbuf, complen, decomp, param1, param2, workmem, rate);
+
+    if (params->cold && !decomp_error && complen > 0)
+        cold_report(params, desc, chunk_sizes, compr_sizes, inbuf, compbuf, decomp, param1, param2, workmem, rate);
+
+    if (params->streams && !decomp_error && complen > 0)
+        streams_report(params, desc, chunk_sizes, compr_sizes, inbuf, compbuf, decomp, param1, param2, rate);
+
+    if (params->workload && !decomp_error && complen > 0)
+        workload_report(params, desc, inbuf, insize, decomp, param1, param2, workmem, rate);
+
+ //   printf("total_c_iters=%d total_d_iters=%d            \n", total_c_iters, total_d_iters);
+    print_stats(params, desc, level, ctime, dtime, cloops, dloops, insize, complen, chunk_size, decomp_error);
+    if (!cache_key_str.empty())
+    {
+        string_table_t& row = params->results.back();
+        cache_entry_t e = { row.col2_ctime, row.col3_dtime, row.col4_comprsize, row.col5_origsize };
+        cache_store(params->cache, cache_key_str, &e);
+    }
+
+done:
+    if (desc->deinit) desc->deinit(workmem);
+}
+
+
+/* codec families with a native checksum and the entry that enables it, with the same compressed payload; lz4frame is
+   not one of them, its levels 0-2 are not lz4hc and its blocks differ from the chunks of lz4 */
+static const struct { compress_func plain; const char* checked; } checked_native[] =
+{
+    { lzbench_zstd_compress,       "zstd_chk" },
+    { lzbench_libdeflate_compress, "libdeflate_gzip" },
+};
+
+
+typedef struct
+{
+    const compressor_desc_t* desc;
+    checksum_func hash;
+    char* workmem;
+} checked_state_t;
+
+
+const checksum_desc_t* find_checksum(const char* name)
+{
+    for (int i=0; i<checksum_desc_count; i++)
+        if (!strcmp(checksum_desc[i].name, name)) return &checksum_desc[i];
+    return NULL;
+}
+
+
+/* the checksum appended by lzbench_checked_compress: the CRC64 of the .xz container for xz, the XXH32 of the content
+   checksum of lz4 frames for lz4, XXH64 for the others; the wrapped desc may have the functions of an ISA variant */
+const char* checked_hash_name(const compressor_desc_t* desc)
+{
+    if (desc->compress == lzbench_xz_compress || desc->compress == lzbench_xz_adv_compress) return "crc64_xz";
+    for (int i=0; i<ISA_COUNT; i++)
+        if (desc->compress == (compress_func)isa_variant(i, (isa_func_t)lzbench_lz4_compress) ||
+            desc->compress == (compress_func)isa_variant(i, (isa_func_t)lzbench_lz4fast_compress) ||
+            desc->compress == (compress_func)isa_variant(i, (isa_func_t)lzbench_lz4hc_compress)) return "xxh32_lz4";
+    return "xxh64";
+}
+
+
+/* param2 points to the desc of the wrapped codec */
+char* lzbench_checked_init(size_t insize, size_t level, size_t wrapped)
+{
+    checked_state_t* state = (checked_state_t*)calloc(1, sizeof(checked_state_t));
+    if (!state) return NULL;
+
+    state->desc = (const compressor_desc_t*)wrapped;
+    state->hash = find_checksum(checked_hash_name(state->desc))->func;
+    if (state->desc->init) state->workmem = state->desc->init(insize, level, state->desc->additional_param);
+    return (char*)state;
+}
+
+
+void lzbench_checked_deinit(char* workmem)
+{
+    checked_state_t* state = (checked_state_t*)workmem;
+    if (!state) return;
+    if (state->desc->deinit) state->desc->deinit(state->workmem);
+    free(state);
+}
+
+
+int64_t lzbench_checked_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    checked_state_t* state = (checked_state_t*)workmem;
+    if (!state || outsize <= sizeof(uint64_t)) return 0;
+
+    int64_t clen = state->desc->compress(inbuf, insize, outbuf, outsize - sizeof(uint64_t), level, state->desc->additional_param, state->workmem);
+    if (clen <= 0 || clen + sizeof(uint64_t) >= insize) return 0; // stored by lzbench
+    uint64_t hash = state->hash((uint8_t*)inbuf, insize);
+    memcpy(outbuf + clen, &hash, sizeof(hash));
+    return clen + sizeof(hash);
+}
+
+
+int64_t lzbench_checked_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char* workmem)
+{
+    checked_state_t* state = (checked_state_t*)workmem;
+    uint64_t hash;
+    if (!state || insize <= sizeof(hash)) return 0;
+
+    int64_t dlen = state->desc->decompress(inbuf, insize - sizeof(hash), outbuf, outsize, level, state->desc->additional_param, state->workmem);
+    if (dlen <= 0) return dlen;
+    memcpy(&hash, inbuf + insize - sizeof(hash), sizeof(hash));
+    if (state->hash((uint8_t*)outbuf, dlen) != hash) return 0;
+    return dlen;
+}
+
+
+/* with --checked runs the codec again with a native or XXH64 checksum and prints the difference */
+void lzbench_test_checked(lzbench_params_t *params, std::vector<size_t> &file_sizes, const compressor_desc_t* desc, int level, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    size_t first_result = params->results.size();
+    compressor_desc_t checked, wrapped = *desc;
+    std::string name, options, version;
+
+    lzbench_test(params, file_sizes, desc, level, inbuf, insize, compbuf, comprsize, decomp, rate, level);
+    if (!params->checked || params->results.size() == first_result) return;
+
+    if (desc->compress == lzbench_zlib_compress)
+    {
+        LZBENCH_PRINT(2, "%s: zlib format always includes adler32\n", desc->name);
+        return;
+    }
+
+    checked = *desc;
+    if (desc->keys && strstr(desc->keys, "chk")) // the native checksum is a key=value parameter
+    {
+        const char* list = desc->additional_param ? (const char*)desc->additional_param : "";
+        format(options, "%s%schk=1", list, list[0] ? "," : "");
+        format(name, "%s+chk", desc->name);
+        checked.name = name.c_str();
+        checked.additional_param = (size_t)options.c_str();
+    }
+    else for (size_t i=0; i<sizeof(checked_native)/sizeof(checked_native[0]); i++)
+        if (desc->compress == checked_native[i].plain)
+            for (int j=1; j<LZBENCH_COMPRESSOR_COUNT; j++)
+                if (!strcmp(comp_desc[j].name, checked_native[i].checked))
+                {
+                    checked = comp_desc[j];
+                    checked.additional_param = desc->additional_param; // e.g. window size of zstd22
+                    checked.first_level = desc->first_level;
+                    checked.last_level = desc->last_level;
+                }
+
+    if (checked.compress == desc->compress && !options.size())
+    {
+        std::string hash = checked_hash_name(desc);
+        format(name, "%s+%s", desc->name, hash.substr(0, hash.find('_')).c_str());
+        checked.name = name.c_str();
+        // lzbench_test picks the variants of the ISA only for the codec itself, so the wrapped one gets them here
+        wrapped.compress = (compress_func)isa_variant(params->isa, (isa_func_t)desc->compress);
+        wrapped.decompress = (compress_func)isa_variant(params->isa, (isa_func_t)desc->decompress);
+        wrapped.init = (init_func)isa_variant(params->isa, (isa_func_t)desc->init);
+        wrapped.deinit = (deinit_func)isa_variant(params->isa, (isa_func_t)desc->deinit);
+        if (params->isa_list && isa_has_variant((isa_func_t)desc->compress))
+        {
+            format(version, "%s %s", desc->version, isa_names[params->isa]);
+            checked.version = version.c_str();
+        }
+        checked.additional_param = (size_t)&wrapped;
+        checked.compress = lzbench_checked_compress;
+        checked.decompress = lzbench_checked_decompress;
+        checked.init = lzbench_checked_init;
+        checked.deinit = lzbench_checked_deinit;
+    }
+
+    lzbench_test(params, file_sizes, &checked, level, inbuf, insize, compbuf, comprsize, decomp, rate, level);
+    if (params->results.size() != first_result + 2) return;
+
+    string_table_t& plain = params->results[first_result];
+    string_table_t& check = params->results[first_result + 1];
+    LZBENCH_PRINT(2, "%s checksum overhead: compression %+.1f%%, decompression %+.1f%%, size %+lld bytes\n", checked.name,
+        plain.col2_ctime ? (check.col2_ctime * 100.0 / plain.col2_ctime - 100.0) : 0.0,
+        (plain.col3_dtime && check.col3_dtime) ? (check.col3_dtime * 100.0 / plain.col3_dtime - 100.0) : 0.0,
+        (long long)check.col4_comprsize - (long long)plain.col4_comprsize);
+}
+
+
+/* streaming variants of --linked, keyed by the compress function of the plain codec */
+static const struct { compress_func plain; compress_func compress; compress_func decompress; init_func init; deinit_func deinit; deinit_func reset; } linked_native[] =
+{
+    { lzbench_lz4_compress,    lzbench_lz4_linked_compress,     lzbench_lz4_linked_decompress,    lzbench_lz4_linked_init,    lzbench_lz4_linked_deinit,    lzbench_lz4_linked_reset },
+    { lzbench_lz4fast_compress, lzbench_lz4fast_linked_compress, lzbench_lz4_linked_decompress,   lzbench_lz4_linked_init,    lzbench_lz4_linked_deinit,    lzbench_lz4_linked_reset },
+    { lzbench_lz4hc_compress,  lzbench_lz4hc_linked_compress,   lzbench_lz4_linked_decompress,    lzbench_lz4_linked_init,    lzbench_lz4_linked_deinit,    lzbench_lz4_linked_reset },
+    { lzbench_zstd_compress,   lzbench_zstd_linked_compress,    lzbench_zstd_linked_decompress,   lzbench_zstd_linked_init,   lzbench_zstd_linked_deinit,   lzbench_zstd_linked_reset },
+    { lzbench_zlib_compress,   lzbench_zlib_linked_compress,    lzbench_zlib_linked_decompress,   lzbench_zlib_linked_init,   lzbench_zlib_linked_deinit,   lzbench_zlib_linked_reset },
+    { lzbench_brotli_compress, lzbench_brotli_linked_compress,  lzbench_brotli_linked_decompress, lzbench_brotli_linked_init, lzbench_brotli_linked_deinit, lzbench_brotli_linked_reset },
+};
+
+
+/* with --linked runs the codec again with each chunk compressed on the history of the previous ones and prints the difference */
+void lzbench_test_linked(lzbench_params_t *params, std::vector<size_t> &file_sizes, const compressor_desc_t* desc, int level, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    size_t first_result = params->results.size();
+    compressor_desc_t linked = *desc;
+    deinit_func reset = NULL;
+    std::string name;
+
+    lzbench_test_checked(params, file_sizes, desc, level, inbuf, insize, compbuf, comprsize, decomp, rate);
+    if (!params->linked || params->results.size() == first_result) return;
+
+    for (size_t i=0; i<sizeof(linked_native)/sizeof(linked_native[0]); i++)
+        if (desc->compress == linked_native[i].plain && linked_native[i].compress)
+        {
+            linked.compress = linked_native[i].compress;
+            linked.decompress = linked_native[i].decompress;
+            linked.init = linked_native[i].init;
+            linked.deinit = linked_native[i].deinit;
+            reset = linked_native[i].reset;
+        }
+    if (linked.compress == desc->compress)
+    {
+        LZBENCH_PRINT(2, "%s: no linked mode\n", desc->name);
+        return;
+    }
+    if (params->chunk_size >= insize)
+        LZBENCH_PRINT(2, "%s: --linked compares a single chunk, use -b\n", desc->name);
+
+    format(name, "%s+linked", desc->name);
+    linked.name = name.c_str();
+
+    // the chunks of one pass must all go through the codec in order, so the chunks --estimate would store are compressed too
+    estimator_e estimator = params->estimator;
+    int parse_stats = params->parse_stats, adversarial = params->adversarial, inplace = params->inplace;
+    params->estimator = EST_NONE;
+    params->parse_stats = params->adversarial = params->inplace = 0;
+    params->linked_run = reset;
+    lzbench_test(params, file_sizes, &linked, level, inbuf, insize, compbuf, comprsize, decomp, rate, level);
+    params->linked_run = NULL;
+    params->estimator = estimator;
+    params->parse_stats = parse_stats;
+    params->adversarial = adversarial;
+    params->inplace = inplace;
+    if (params->results.size() < first_result + 2) return;
+
+    string_table_t& plain = params->results[first_result];
+    string_table_t& chained = params->results.back();
+    LZBENCH_PRINT(2, "%s: ratio %.2f%% -> %.2f%% (%+lld bytes), compression time %+.1f%%, decompression time %+.1f%%\n", linked.name,
+        plain.col5_origsize ? plain.col4_comprsize * 100.0 / plain.col5_origsize : 0.0,
+        chained.col5_origsize ? chained.col4_comprsize * 100.0 / chained.col5_origsize : 0.0,
+        (long long)chained.col4_comprsize - (long long)plain.col4_comprsize,
+        plain.col2_ctime ? (chained.col2_ctime * 100.0 / plain.col2_ctime - 100.0) : 0.0,
+        (plain.col3_dtime && chained.col3_dtime) ? (chained.col3_dtime * 100.0 / plain.col3_dtime - 100.0) : 0.0);
+}
+
+
+/* with --isa=list the codecs that have instruction set variants run once per listed ISA */
+void lzbench_test_isa(lzbench_params_t *params, std::vector<size_t> &file_sizes, const compressor_desc_t* desc, int level, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    if (!params->isa_list || !isa_has_variant((isa_func_t)desc->compress))
+    {
+        lzbench_test_linked(params, file_sizes, desc, level, inbuf, insize, compbuf, comprsize, decomp, rate);
+        return;
+    }
+
+    int selected = params->isa;
+    std::vector<std::string> names = split(params->isa_list, ',');
+    for (size_t k=0; k<names.size(); k++)
+    {
+        params->isa = isa_find(names[k].c_str());
+        lzbench_test_linked(params, file_sizes, desc, level, inbuf, insize, compbuf, comprsize, decomp, rate);
+    }
+    params->isa = selected;
+}
+
+
+/* the keys of a key=value list of -e must be among the keys of the codec, the values are checked by the codec */
+bool options_valid(const compressor_desc_t* desc, const std::string& options)
+{
+    std::vector<std::string> keys, list = split(options, ',');
+
+    if (!desc->keys)
+    {
+        printf("%s: no key=value parameters\n", desc->name);
+        return false;
+    }
+    keys = split(desc->keys, ',');
+    for (size_t i=0; i<list.size(); i++)
+    {
+        std::string key = list[i].substr(0, list[i].find('='));
+        size_t k = 0;
+        while (k < keys.size() && keys[k] != key) k++;
+        if (k == keys.size())
+        {
+            printf("%s: unknown parameter %s (keys: %s)\n", desc->name, key.c_str(), desc->keys);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void lzbench_test_with_params(lzbench_params_t *params, std::vector<size_t> &file_sizes, const char *namesWithParams, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    std::vector<std::string> cnames, cparams;
+    std::string options;
+    compressor_desc_t desc;
+
+	if (!namesWithParams || !namesWithParams[0]) return;
+
+    LZBENCH_PRINT(5, "*** lzbench_test_with_params insize=%d comprsize=%d\n", (int)insize, (int)comprsize);
+
+    cnames = split(namesWithParams, '/');
+
+    for (int k=0; k<cnames.size(); k++)
+        LZBENCH_PRINT(5, "cnames[%d] = %s\n", k, cnames[k].c_str());
+
+    for (int k=0; k<cnames.size(); k++)
+    {
+        bool alias = false;
+        for (int i=0; i<LZBENCH_ALIASES_COUNT; i++)
+        {
+            if (istrcmp(cnames[k].c_str(), alias_desc[i].name)==0)
+            {
+                lzbench_test_with_params(params, file_sizes, alias_desc[i].params, inbuf, insize, compbuf, comprsize, decomp, rate);
+                alias = true;
+            }
+        }
+        for (size_t i=0; i<plugin_aliases.size(); i++) // also extends a built-in alias
+        {
+            if (istrcmp(cnames[k].c_str(), plugin_aliases[i].name)==0)
+            {
+                lzbench_test_with_params(params, file_sizes, plugin_aliases[i].params, inbuf, insize, compbuf, comprsize, decomp, rate);
+                alias = true;
+            }
+        }
+        if (alias) goto next_k;
+
+        LZBENCH_PRINT(5, "params = %s\n", cnames[k].c_str());
+        cparams = split(cnames[k].c_str(), ',');
+        options.clear();
+        for (size_t j=cparams.size(); j-- > 1; )
+            if (cparams[j].find('=') != std::string::npos)
+            {
+                options = cparams[j] + (options.empty() ? "" : ",") + options;
+                cparams.erase(cparams.begin() + j);
+            }
+        if (cparams.size() >= 1)
+        {
+            int j=1;
+            do {
+                const compressor_desc_t* found = find_compressor(cparams[0].c_str());
+                if (!found) { if (!params->quiet) printf("NOT FOUND: %s %s\n", cparams[0].c_str(), (j<cparams.size()) ? cparams[j].c_str() : NULL); }
+                else if (options.empty() || options_valid(found, options))
+                {
+                    desc = *found;
+                    if (!options.empty())
+                        desc.additional_param = (size_t)options.c_str();
+                    if (j >= cparams.size())
+                    {
+                        for (int level=desc.first_level; level<=desc.last_level; level++)
+                            lzbench_test_isa(params, file_sizes, &desc, level, inbuf, insize, compbuf, comprsize, decomp, rate);
+                    }
+                    else
+                        lzbench_test_isa(params, file_sizes, &desc, atoi(cparams[j].c_str()), inbuf, insize, compbuf, comprsize, decomp, rate);
+                }
+                j++;
+            }
+            while (j < cparams.size());
+        }
+next_k:
+        continue;
+    }
+}
+
+
+/* hashes the input in chunks with the same loop settings as compression, returns the time of one pass */
+uint64_t checksum_test(lzbench_params_t *params, std::vector<size_t> &file_sizes, const checksum_desc_t* desc, uint8_t *inbuf, size_t insize, bench_rate_t rate)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks, timer_ticks;
+    uint64_t nanosec, total_nanosec, htime;
+    std::vector<uint64_t> times;
+    std::vector<size_t> chunk_sizes;
+    std::string col1_algname;
+    static volatile uint64_t sink;
+    size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
+    int i, total_iters = 0;
+
+    for (int i=0; i<file_sizes.size(); i++) {
+        size_t tmpsize = file_sizes[i];
+        while (tmpsize > 0)
+        {
+            chunk_sizes.push_back(MIN(tmpsize, chunk_size));
+            tmpsize -= MIN(tmpsize, chunk_size);
+        }
+    }
+
+    GetTime(timer_ticks);
+    do
+    {
+        i = 0;
+        uni_sleep(1); // give processor to other processes
+        GetTime(loop_ticks);
+        do
+        {
+            uint8_t *p = inbuf;
+            uint64_t sum = 0;
+            GetTime(start_ticks);
+            for (size_t c=0; c<chunk_sizes.size(); p += chunk_sizes[c], c++)
+                sum ^= desc->func(p, chunk_sizes[c]);
+            GetTime(end_ticks);
+            sink = sum;
+            nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+            if (nanosec >= 10000) times.push_back(nanosec);
+            i++;
+        }
+        while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
+
+        nanosec = GetDiffTime(rate, loop_ticks, end_ticks);
+        times.push_back(nanosec/i);
+
+        total_nanosec = GetDiffTime(rate, timer_ticks, end_ticks);
+        total_iters += i;
+        if ((total_iters >= params->c_iters) && (total_nanosec > ((uint64_t)params->cmintime*1000000))) break;
+        LZBENCH_PRINT(2, "%s iter=%d time=%.2fs speed=%.2f MB/s     \r", desc->name, total_iters, total_nanosec/1000000000.0, (float)insize*i*1000/nanosec);
+    }
+    while (true);
+
+    htime = select_time(params, times);
+    format(col1_algname, "%s %s", desc->name, desc->version);
+    params->results.push_back(string_table_t(col1_algname, htime, htime, insize, insize, params->in_filename, chunk_size));
+    if (params->show_speed)
+        print_speed(params, params->results[params->results.size()-1]);
+    else
+        print_time(params, params->results[params->results.size()-1]);
+    return htime;
+}
+
+
+/* -H list, the checksum time is added to both compression and decompression of results from first_result */
+void checksum_test_with_params(lzbench_params_t *params, std::vector<size_t> &file_sizes, uint8_t *inbuf, size_t insize, bench_rate_t rate, size_t first_result)
+{
+    std::vector<std::string> names = split(params->checksum_list, ',');
+    size_t last_result = params->results.size();
+
+    for (size_t k=0; k<names.size(); k++)
+    {
+        bool found = false;
+        for (int i=0; i<checksum_desc_count; i++)
+        {
+            if (istrcmp(names[k].c_str(), "all") && istrcmp(names[k].c_str(), checksum_desc[i].name)) continue;
+            found = true;
+
+            uint64_t htime = checksum_test(params, file_sizes, &checksum_desc[i], inbuf, insize, rate);
+            for (size_t r=first_result; r<last_result; r++)
+            {
+                string_table_t row = params->results[r];
+                row.col1_algname += std::string(" + ") + checksum_desc[i].name;
+                row.col2_ctime += htime;
+                if (row.col3_dtime) row.col3_dtime += htime;
+                params->results.push_back(row);
+                if (params->show_speed)
+                    print_speed(params, params->results[params->results.size()-1]);
+                else
+                    print_time(params, params->results[params->results.size()-1]);
+            }
+        }
+        if (!found) printf("NOT FOUND: %s\n", names[k].c_str());
+    }
+}
+
+
+/* -E list, order-0 entropy coders run like codecs on the input or with --literals on the literals of an lz4 pass */
+void entropy_test_with_params(lzbench_params_t *params, std::vector<size_t> &file_sizes, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    std::vector<std::string> names = split(params->entropy_list, ',');
+    std::vector<size_t> sizes = file_sizes;
+    std::vector<uint8_t> literals;
+    uint8_t *data = inbuf;
+    size_t datasize = insize;
+    uint32_t count[256];
+    double bits = 0;
+
+    if (params->entropy_literals)
+    {
+        size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
+        uint8_t *p = inbuf;
+        literals.resize(insize);
+        sizes.clear();
+        datasize = 0;
+        for (size_t f=0; f<file_sizes.size(); f++)
+            for (size_t left = file_sizes[f], part; left > 0; p += part, left -= part)
+            {
+                part = MIN(left, chunk_size);
+                size_t n = entropy_lz4_literals(p, part, &literals[datasize], compbuf, comprsize);
+                if (n) sizes.push_back(n);
+                datasize += n;
+            }
+        if (!datasize) { printf("-E: no lz4 literals\n"); return; }
+        data = &literals[0];
+        LZBENCH_PRINT(2, "lz4 literals: %lld of %lld bytes\n", (long long)datasize, (long long)insize);
+    }
+
+    memset(count, 0, sizeof(count));
+    for (size_t i=0; i<datasize; i++) count[data[i]]++;
+    for (int i=0; i<256; i++)
+        if (count[i]) bits -= count[i] * log2((double)count[i] / datasize);
+
+    for (size_t k=0; k<names.size(); k++)
+    {
+        bool found = false;
+        for (int i=0; i<entropy_desc_count; i++)
         {
-            chunk_sizes.push_back(MIN(tmpsize, chunk_size));
-            tmpsize -= MIN(tmpsize, chunk_size);
+            if (istrcmp(names[k].c_str(), "all") && istrcmp(names[k].c_str(), entropy_desc[i].name)) continue;
+            found = true;
+
+            std::string version = entropy_desc[i].version;
+            if (params->entropy_literals) version += " lz4-literals";
+            compressor_desc_t desc = { entropy_desc[i].name, version.c_str(), 0, 0, 0, 0, entropy_desc[i].compress, entropy_desc[i].decompress, NULL, NULL };
+            size_t last_result = params->results.size();
+
+            lzbench_test(params, sizes, &desc, 0, data, datasize, compbuf, comprsize, decomp, rate, 0);
+            if (params->results.size() > last_result)
+                LZBENCH_PRINT(2, "%s: %.3f bits/byte with %d stream(s), order-0 entropy %.3f bits/byte\n", entropy_desc[i].name,
+                    params->results.back().col4_comprsize * 8.0 / datasize, entropy_desc[i].streams, bits / datasize);
         }
+        if (!found) printf("NOT FOUND: %s\n", names[k].c_str());
     }
-    
-    LZBENCH_PRINT(5, "%s chunk_sizes=%d\n", desc->name, (int)chunk_sizes.size());
+}
+
+
+/* runs the match finder over the chunks with the loop settings of compression, sets the time of one pass and returns MF_OK or the failure */
+int mf_test(lzbench_params_t *params, std::vector<size_t> &chunk_sizes, const mf_desc_t* desc, uint8_t *inbuf, bench_rate_t rate, mf_stats_t* stats, uint64_t* mtime)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks, timer_ticks;
+    uint64_t nanosec, total_nanosec;
+    std::vector<uint64_t> times;
+    int i, status, total_iters = 0;
+
+    if (chunk_sizes.empty()) return MF_NO_INPUT;
 
-    total_c_iters = 0;
     GetTime(timer_ticks);
     do
     {
@@ -370,161 +2196,280 @@ void lzbench_test(lzbench_params_t *params, std::vector<size_t> &file_sizes, con
         GetTime(loop_ticks);
         do
         {
+            uint8_t *p = inbuf;
+            memset(stats, 0, sizeof(mf_stats_t));
             GetTime(start_ticks);
-            complen = lzbench_compress(params, chunk_sizes, desc->compress, compr_sizes, inbuf, compbuf, comprsize, param1, param2, workmem);
+            for (size_t c=0; c<chunk_sizes.size(); p += chunk_sizes[c], c++)
+                if ((status = desc->run(p, chunk_sizes[c], stats)) != MF_OK) return status;
             GetTime(end_ticks);
             nanosec = GetDiffTime(rate, start_ticks, end_ticks);
-            if (nanosec >= 10000) ctime.push_back(nanosec);
+            if (nanosec >= 10000) times.push_back(nanosec);
             i++;
         }
         while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
 
         nanosec = GetDiffTime(rate, loop_ticks, end_ticks);
-        ctime.push_back(nanosec/i);
-        speed = (float)insize*i*1000/nanosec;
-        LZBENCH_PRINT(8, "%s nanosec=%d\n", desc->name, (int)nanosec);
-
-        if ((uint32_t)speed < params->cspeed) { LZBENCH_PRINT(7, "%s slower than %d MB/s\n", desc->name, (uint32_t)speed); return; }
+        times.push_back(nanosec/i);
 
         total_nanosec = GetDiffTime(rate, timer_ticks, end_ticks);
-        total_c_iters += i;
-        if ((total_c_iters >= params->c_iters) && (total_nanosec > ((uint64_t)params->cmintime*1000000))) break;
-        LZBENCH_PRINT(2, "%s compr iter=%d time=%.2fs speed=%.2f MB/s     \r", desc->name, total_c_iters, total_nanosec/1000000000.0, speed);
+        total_iters += i;
+        if ((total_iters >= params->c_iters) && (total_nanosec > ((uint64_t)params->cmintime*1000000))) break;
+        LZBENCH_PRINT(2, "%s iter=%d time=%.2fs     \r", desc->name, total_iters, total_nanosec/1000000000.0);
     }
     while (true);
 
+    *mtime = MAX(select_time(params, times), 1);
+    return MF_OK;
+}
 
-    total_d_iters = 0;
-    GetTime(timer_ticks);
-    if (!params->compress_only)
-    do
+
+/* --mf list, positions per second, matched positions, average longest match and memory of each match finder */
+void mf_test_with_params(lzbench_params_t *params, std::vector<size_t> &file_sizes, uint8_t *inbuf, size_t insize, bench_rate_t rate)
+{
+    std::vector<std::string> names = split(params->mf_list, ',');
+    std::vector<size_t> chunk_sizes;
+    size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
+
+    for (size_t f=0; f<file_sizes.size(); f++)
+        for (size_t left = file_sizes[f]; left > 0; left -= MIN(left, chunk_size))
+            chunk_sizes.push_back(MIN(left, chunk_size));
+
+    for (size_t k=0; k<names.size(); k++)
     {
-        i = 0;
-        uni_sleep(1); // give processor to other processes
-        GetTime(loop_ticks);
-        do
+        bool found = false;
+        for (int i=0; i<mf_desc_count; i++)
         {
-            GetTime(start_ticks);
-            decomplen = lzbench_decompress(params, chunk_sizes, desc->decompress, compr_sizes, compbuf, decomp, param1, param2, workmem);
-            GetTime(end_ticks);
-            nanosec = GetDiffTime(rate, start_ticks, end_ticks);
-            if (nanosec >= 10000) dtime.push_back(nanosec);
-            i++;
+            if (istrcmp(names[k].c_str(), "all") && istrcmp(names[k].c_str(), mf_desc[i].name)) continue;
+            found = true;
+
+            mf_stats_t stats;
+            uint64_t mtime;
+            int status = mf_test(params, chunk_sizes, &mf_desc[i], inbuf, rate, &stats, &mtime);
+            if (status != MF_OK) { printf("%s: %s\n", mf_desc[i].name, (status == MF_NO_MEMORY) ? "out of memory" : "no input"); continue; }
+            LZBENCH_PRINT(2, "%-14s %-16s %-17s %8.2f Mpos/s, %5.1f%% positions matched, average match %6.2f, memory %llu KB\n",
+                mf_desc[i].name, mf_desc[i].version, mf_desc[i].params, stats.positions * 1000.0 / mtime,
+                stats.positions ? stats.matches * 100.0 / stats.positions : 0.0, stats.matches ? (double)stats.len_sum / stats.matches : 0.0,
+                (unsigned long long)(stats.memory >> 10));
         }
-        while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
+        if (!found) printf("NOT FOUND: %s\n", names[k].c_str());
+    }
+}
 
-        nanosec = GetDiffTime(rate, loop_ticks, end_ticks);
-        dtime.push_back(nanosec/i);
-        LZBENCH_PRINT(9, "%s dnanosec=%d\n", desc->name, (int)nanosec);
 
-        if (insize != decomplen)
-        {   
-            decomp_error = true;
-            LZBENCH_PRINT(5, "ERROR: inlen[%d] != outlen[%d]\n", (int32_t)insize, (int32_t)decomplen);
-        }
-        
-        if (memcmp(inbuf, decomp, insize) != 0)
-        {
-            decomp_error = true;
+typedef struct
+{
+    zstd_point_t point;
+    uint64_t ctime, dtime;
+    int64_t complen;
+    bool expanded;
+} zstd_search_result_t;
 
-            size_t cmn = common(inbuf, decomp);
-            LZBENCH_PRINT(5, "ERROR in %s: common=%d/%d\n", desc->name, (int32_t)cmn, (int32_t)insize);
-            
-            if (params->verbose >= 10)
-            {
-                char text[256];
-                snprintf(text, sizeof(text), "%s_failed", desc->name);
-                cmn /= chunk_size;
-                size_t err_size = MIN(insize, (cmn+1)*chunk_size);
-                err_size -= cmn*chunk_size;
-                printf("ERROR: fwrite %d-%d to %s\n", (int32_t)(cmn*chunk_size), (int32_t)(cmn*chunk_size+err_size), text);
-                FILE *f = fopen(text, "wb");
-                if (f) fwrite(inbuf+cmn*chunk_size, 1, err_size, f), fclose(f);
-                exit(1);
-            }
-        }
 
-        memset(decomp, 0, insize); // clear output buffer
+/* the fastest compression and decompression of the chunks within one loop time each, false if the data does not decode */
+bool zstd_search_measure(lzbench_params_t *params, const compressor_desc_t* desc, int level, std::vector<size_t> &chunk_sizes, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate, zstd_search_result_t* r)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    std::vector<size_t> compr_sizes;
+    char options[256];
+    int64_t decomplen;
 
-        if (decomp_error) break;
-        
-        total_nanosec = GetDiffTime(rate, timer_ticks, end_ticks);
-        total_d_iters += i;
-        if ((total_d_iters >= params->d_iters) && (total_nanosec > ((uint64_t)params->dmintime*1000000))) break;
-        LZBENCH_PRINT(2, "%s decompr iter=%d time=%.2fs speed=%.2f MB/s     \r", desc->name, total_d_iters, total_nanosec/1000000000.0, (float)insize*i*1000/nanosec);
+    zstd_search_format(&r->point, options, sizeof(options));
+    char* workmem = lzbench_zstd_adv_search_init(chunk_sizes[0], level, (size_t)options);  // without the messages of the rejected parameter sets
+    if (!workmem) return false;
+
+    r->ctime = r->dtime = UINT64_MAX;
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        r->complen = lzbench_compress(params, chunk_sizes, desc->compress, compr_sizes, inbuf, compbuf, comprsize, level, (size_t)options, workmem);
+        GetTime(end_ticks);
+        r->ctime = MIN(r->ctime, GetDiffTime(rate, start_ticks, end_ticks));
     }
-    while (true);
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->cloop_time);
 
- //   printf("total_c_iters=%d total_d_iters=%d            \n", total_c_iters, total_d_iters);
-    print_stats(params, desc, level, ctime, dtime, insize, complen, decomp_error);
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        decomplen = lzbench_decompress(params, chunk_sizes, desc->decompress, compr_sizes, compbuf, decomp, level, (size_t)options, workmem);
+        GetTime(end_ticks);
+        r->dtime = MIN(r->dtime, GetDiffTime(rate, start_ticks, end_ticks));
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < params->dloop_time);
 
-done:
-    if (desc->deinit) desc->deinit(workmem);
+    desc->deinit(workmem);
+    return r->complen > 0 && decomplen == (int64_t)insize && memcmp(inbuf, decomp, insize) == 0 && r->ctime && r->dtime;
 }
 
 
-void lzbench_test_with_params(lzbench_params_t *params, std::vector<size_t> &file_sizes, const char *namesWithParams, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+/* the results on the Pareto front of compression time and size, of those with at least the given compression speed */
+void zstd_search_front(std::vector<zstd_search_result_t> &results, size_t insize, double cspeed, std::vector<size_t> &front)
 {
-    std::vector<std::string> cnames, cparams;
-
-	if (!namesWithParams) return;
-
-    LZBENCH_PRINT(5, "*** lzbench_test_with_params insize=%d comprsize=%d\n", (int)insize, (int)comprsize);
+    front.clear();
+    for (size_t i=0; i<results.size(); i++)
+    {
+        if (insize * 1000.0 / results[i].ctime < cspeed) continue;
+        bool dominated = false;
+        for (size_t j=0; j<results.size() && !dominated; j++)
+            dominated = (j != i) && insize * 1000.0 / results[j].ctime >= cspeed && results[j].ctime <= results[i].ctime && results[j].complen <= results[i].complen
+                && (results[j].ctime < results[i].ctime || results[j].complen < results[i].complen || j < i);
+        if (!dominated) front.push_back(i);
+    }
+}
 
-    cnames = split(namesWithParams, '/');
 
-    for (int k=0; k<cnames.size(); k++)
-        LZBENCH_PRINT(5, "cnames[%d] = %s\n", k, cnames[k].c_str());
+/* --zstd-search=level[,MB/s], local search of zstd_adv parameters from those of the level, prints the Pareto front */
+void zstd_search_test(lzbench_params_t *params, std::vector<size_t> &file_sizes, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    std::vector<std::string> args = split(params->zstd_search, ',');
+    int level = args.size() ? atoi(args[0].c_str()) : 3;
+    double cspeed = (args.size() > 1) ? atof(args[1].c_str()) : 0.0;
+    size_t chunk_size = (params->chunk_size > insize) ? insize : params->chunk_size;
+    std::vector<size_t> chunk_sizes, front;
+    std::vector<zstd_search_result_t> results;
+    zstd_point_t neighbours[2 * ZSTD_SEARCH_DIMS];
+    const compressor_desc_t* desc = NULL;
+    char options[256];
+
+    for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
+        if (!strcmp(comp_desc[i].name, "zstd_adv") && comp_desc[i].compress) desc = &comp_desc[i];
+    if (!desc) { printf("NOT FOUND: zstd_adv\n"); return; }
+
+    for (size_t f=0; f<file_sizes.size(); f++)
+        for (size_t left = file_sizes[f]; left > 0; left -= MIN(left, chunk_size))
+            chunk_sizes.push_back(MIN(left, chunk_size));
+
+    zstd_search_result_t r;
+    memset(&r, 0, sizeof(r));
+    zstd_search_start(level, chunk_size, &r.point);
+    if (!zstd_search_measure(params, desc, level, chunk_sizes, inbuf, insize, compbuf, comprsize, decomp, rate, &r))
+    {
+        printf("zstd_adv: level %d failed\n", level);
+        return;
+    }
+    results.push_back(r);
 
-    for (int k=0; k<cnames.size(); k++)
+    // expand the points of the front until it stops changing, or the fastest point while none is within the budget
+    while (results.size() < ZSTD_SEARCH_MAX_POINTS)
     {
-        for (int i=0; i<LZBENCH_ALIASES_COUNT; i++)
+        zstd_search_front(results, insize, cspeed, front);
+        if (front.empty())
         {
-            if (istrcmp(cnames[k].c_str(), alias_desc[i].name)==0)
+            size_t fastest = 0;
+            for (size_t i=1; i<results.size(); i++)
+                if (results[i].ctime < results[fastest].ctime) fastest = i;
+            front.push_back(fastest);
+        }
+        size_t next = results.size();
+        for (size_t i=0; i<front.size() && next == results.size(); i++)
+            if (!results[front[i]].expanded) next = front[i];
+        if (next == results.size()) break;
+
+        results[next].expanded = true;
+        int count = zstd_search_neighbours(&results[next].point, neighbours);
+        for (int n=0; n<count && results.size() < ZSTD_SEARCH_MAX_POINTS; n++)
+        {
+            size_t k = 0;
+            while (k < results.size() && memcmp(&results[k].point, &neighbours[n], sizeof(zstd_point_t))) k++;
+            if (k < results.size()) continue;
+
+            memset(&r, 0, sizeof(r));
+            r.point = neighbours[n];
+            if (!zstd_search_measure(params, desc, level, chunk_sizes, inbuf, insize, compbuf, comprsize, decomp, rate, &r))
             {
-                lzbench_test_with_params(params, file_sizes, alias_desc[i].params, inbuf, insize, compbuf, comprsize, decomp, rate);
-                goto next_k;
+                r.ctime = r.dtime = UINT64_MAX; // kept so the point is not tried again, never on the front
+                r.complen = INT64_MAX;
+                r.expanded = true;
             }
+            results.push_back(r);
+            LZBENCH_PRINT(2, "zstd_adv %d: %d parameter sets     \r", level, (int)results.size());
         }
+    }
 
-        LZBENCH_PRINT(5, "params = %s\n", cnames[k].c_str());
-        cparams = split(cnames[k].c_str(), ',');
-        if (cparams.size() >= 1)
+    zstd_search_front(results, insize, cspeed, front);
+    for (size_t i=0; i<front.size(); i++) // fastest first
+        for (size_t j=i+1; j<front.size(); j++)
+            if (results[front[j]].ctime < results[front[i]].ctime) std::swap(front[i], front[j]);
+    LZBENCH_PRINT(2, "zstd_adv %d: Pareto front of %d parameter sets", level, (int)results.size());
+    if (cspeed > 0) LZBENCH_PRINT(2, " with compression over %.2f MB/s", cspeed);
+    LZBENCH_PRINT(2, "%s\n", front.empty() ? ", none within the budget" : "");
+    for (size_t i=0; i<front.size(); i++)
+    {
+        zstd_search_result_t& f = results[front[i]];
+        zstd_search_format(&f.point, options, sizeof(options));
+        LZBENCH_PRINT(2, "-ezstd_adv,%d,%-62s %8.2f MB/s %8.2f MB/s %10lld %6.2f%s\n", level, options, insize * 1000.0 / f.ctime,
+            insize * 1000.0 / f.dtime, (long long)f.complen, f.complen * 100.0 / insize, (front[i] == 0) ? "  (level)" : "");
+    }
+}
+
+
+void lzbench_test_list(lzbench_params_t *params, std::vector<size_t> &file_sizes, const char *namesWithParams, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    size_t first_result = params->results.size();
+
+    lzbench_test_with_params(params, file_sizes, namesWithParams, inbuf, insize, compbuf, comprsize, decomp, rate);
+    if (params->checksum_list)
+        checksum_test_with_params(params, file_sizes, inbuf, insize, rate, first_result);
+    if (params->entropy_list)
+        entropy_test_with_params(params, file_sizes, inbuf, insize, compbuf, comprsize, decomp, rate);
+    if (params->mf_list)
+        mf_test_with_params(params, file_sizes, inbuf, insize, rate);
+    if (params->zstd_search)
+        zstd_search_test(params, file_sizes, inbuf, insize, compbuf, comprsize, decomp, rate);
+}
+
+
+/* runs the encoder list once, or once per power-of-two block size with --block-sweep */
+void lzbench_test_blocks(lzbench_params_t *params, std::vector<size_t> &file_sizes, const char *namesWithParams, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    size_t chunk_size = params->chunk_size;
+
+    if (params->cache)
+        params->input_hash = find_checksum("xxh64")->func(inbuf, insize);
+    if (!params->sweep_min)
+    {
+        lzbench_test_list(params, file_sizes, namesWithParams, inbuf, insize, compbuf, comprsize, decomp, rate);
+        return;
+    }
+
+    for (size_t block = params->sweep_min; block <= params->sweep_max; block *= 2)
+    {
+        params->chunk_size = block;
+        if (params->textformat != CSV && params->textformat != JSON)
         {
-            int j=1;
-            do {
-                bool found = false;
-                for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
-                {
-                    if (istrcmp(comp_desc[i].name, cparams[0].c_str()) == 0)
-                    {
-                        found = true;
-                       // printf("%s %s %s\n", cparams[0].c_str(), comp_desc[i].version, cparams[j].c_str());
-                        if (j >= cparams.size())
-                        {                          
-                            for (int level=comp_desc[i].first_level; level<=comp_desc[i].last_level; level++)
-                                lzbench_test(params, file_sizes, &comp_desc[i], level, inbuf, insize, compbuf, comprsize, decomp, rate, level);
-                        }
-                        else
-                            lzbench_test(params, file_sizes, &comp_desc[i], atoi(cparams[j].c_str()), inbuf, insize, compbuf, comprsize, decomp, rate, atoi(cparams[j].c_str()));
-                        break;
-                    }
-                }
-                if (!found) printf("NOT FOUND: %s %s\n", cparams[0].c_str(), (j<cparams.size()) ? cparams[j].c_str() : NULL);
-                j++;
-            }
-            while (j < cparams.size());
+            if (block >= (1<<20)) printf("Block size %d MB:\n", (int)(block >> 20));
+            else printf("Block size %d KB:\n", (int)(block >> 10));
         }
-next_k:
-        continue;
+        lzbench_test_list(params, file_sizes, namesWithParams, inbuf, insize, compbuf, comprsize, decomp, rate);
+        if (block >= insize) break; // larger blocks give the same results
+    }
+    params->chunk_size = chunk_size;
+}
+
+
+/* benchmarks one input of the session, the first one also prints the header and the memcpy row */
+void lzbench_session_input(lzbench_session_t *s, std::vector<size_t> &file_sizes, uint8_t *inbuf, size_t insize, uint8_t *compbuf, size_t comprsize, uint8_t *decomp, bench_rate_t rate)
+{
+    lzbench_params_t *params = &s->params;
+
+    if (!s->inputs++ && !params->quiet)
+    {
+        lzbench_params_t params_memcpy;
+
+        print_header(params);
+        memcpy_baseline_params(params, &params_memcpy);
+        lzbench_test(&params_memcpy, file_sizes, &comp_desc[0], 0, inbuf, insize, compbuf, insize, decomp, rate, 0);
     }
+    lzbench_test_blocks(params, file_sizes, s->encoders, inbuf, insize, compbuf, comprsize, decomp, rate);
 }
 
 
-int lzbench_join(lzbench_params_t* params, const char** inFileNames, unsigned ifnIdx, char* encoder_list)
+int lzbench_join(lzbench_session_t* s, const char** inFileNames, unsigned ifnIdx)
 {
+    lzbench_params_t* params = &s->params;
     bench_rate_t rate;
-    size_t comprsize, insize, inpos, totalsize;
+    size_t comprsize, insize, inpos, totalsize, allocsize;
     uint8_t *inbuf, *compbuf, *decomp;
     std::vector<size_t> file_sizes;
     std::string text;
@@ -538,9 +2483,9 @@ int lzbench_join(lzbench_params_t* params, const char** inFileNames, unsigned if
     }
     
     comprsize = GET_COMPRESS_BOUND(totalsize);
-    inbuf = (uint8_t*)alloc_and_touch(totalsize + PAD_SIZE, false);
-    compbuf = (uint8_t*)alloc_and_touch(comprsize, false);
-    decomp = (uint8_t*)alloc_and_touch(totalsize + PAD_SIZE, true);
+    inbuf = (uint8_t*)alloc_and_touch(params, totalsize + PAD_SIZE, false);
+    compbuf = (uint8_t*)alloc_and_touch(params, comprsize, false);
+    decomp = (uint8_t*)alloc_and_touch(params, totalsize + PAD_SIZE, true);
 
     if (!inbuf || !compbuf || !decomp)
     {
@@ -549,6 +2494,7 @@ int lzbench_join(lzbench_params_t* params, const char** inFileNames, unsigned if
     }
 
     InitTimer(rate);
+    allocsize = totalsize;
     inpos = 0;
 
     for (int i=0; i<ifnIdx; i++)
@@ -583,34 +2529,22 @@ int lzbench_join(lzbench_params_t* params, const char** inFileNames, unsigned if
     LZBENCH_PRINT(5, "totalsize=%d comprsize=%d inpos=%d\n", (int)totalsize, (int)comprsize, (int)inpos);
     totalsize = inpos;
 
-    {
-        std::vector<size_t> single_file;
-        lzbench_params_t params_memcpy;
-
-        print_header(params);
-        memcpy(&params_memcpy, params, sizeof(lzbench_params_t));
-        params_memcpy.cmintime = params_memcpy.dmintime = 0;
-        params_memcpy.c_iters = params_memcpy.d_iters = 0;
-        params_memcpy.cloop_time = params_memcpy.dloop_time = DEFAULT_LOOP_TIME;
-        single_file.push_back(totalsize);
-        lzbench_test(&params_memcpy, file_sizes, &comp_desc[0], 0, inbuf, totalsize, compbuf, totalsize, decomp, rate, 0);
-    }
-
-    lzbench_test_with_params(params, file_sizes, encoder_list?encoder_list:alias_desc[0].params, inbuf, totalsize, compbuf, comprsize, decomp, rate);
+    lzbench_session_input(s, file_sizes, inbuf, totalsize, compbuf, comprsize, decomp, rate);
 
 _clean:
-    free(inbuf);
-    free(compbuf);
-    free(decomp);
+    free_buffer(params, inbuf, allocsize + PAD_SIZE);
+    free_buffer(params, compbuf, comprsize);
+    free_buffer(params, decomp, allocsize + PAD_SIZE);
 
     return 0;
 }
 
 
-int lzbench_main(lzbench_params_t* params, const char** inFileNames, unsigned ifnIdx, char* encoder_list)
+int lzbench_main(lzbench_session_t* s, const char** inFileNames, unsigned ifnIdx)
 {
+    lzbench_params_t* params = &s->params;
     bench_rate_t rate;
-    size_t comprsize, insize, real_insize;
+    size_t comprsize, insize, real_insize, allocsize;
     uint8_t *inbuf, *compbuf, *decomp;
     std::vector<size_t> file_sizes;
     FILE* in;
@@ -644,9 +2578,10 @@ int lzbench_main(lzbench_params_t* params, const char** inFileNames, unsigned if
 
         comprsize = GET_COMPRESS_BOUND(insize);
     	// printf("insize=%llu comprsize=%llu %llu\n", insize, comprsize, MAX(MEMCPY_BUFFER_SIZE, insize));
-        inbuf = (uint8_t*)alloc_and_touch(insize + PAD_SIZE, false);
-        compbuf = (uint8_t*)alloc_and_touch(comprsize, false);
-        decomp = (uint8_t*)alloc_and_touch(insize + PAD_SIZE, true);
+        allocsize = insize;
+        inbuf = (uint8_t*)alloc_and_touch(params, allocsize + PAD_SIZE, false);
+        compbuf = (uint8_t*)alloc_and_touch(params, comprsize, false);
+        decomp = (uint8_t*)alloc_and_touch(params, allocsize + PAD_SIZE, true);
 
         if (!inbuf || !compbuf || !decomp)
         {
@@ -669,20 +2604,6 @@ int lzbench_main(lzbench_params_t* params, const char** inFileNames, unsigned if
 
         insize = fread(inbuf, 1, insize, in);
 
-        if (i == 0)
-        {
-            print_header(params);
-
-            lzbench_params_t params_memcpy;
-            memcpy(&params_memcpy, params, sizeof(lzbench_params_t));
-            params_memcpy.cmintime = params_memcpy.dmintime = 0;
-            params_memcpy.c_iters = params_memcpy.d_iters = 0;
-            params_memcpy.cloop_time = params_memcpy.dloop_time = DEFAULT_LOOP_TIME;
-            file_sizes.push_back(insize);
-            lzbench_test(&params_memcpy, file_sizes, &comp_desc[0], 0, inbuf, insize, compbuf, insize, decomp, rate, 0);
-            file_sizes.clear();
-        }
-
         if (params->mem_limit && real_insize > params->mem_limit)
         {
             int i;
@@ -693,7 +2614,7 @@ int lzbench_main(lzbench_params_t* params, const char** inFileNames, unsigned if
                 format(partname, "%s part %d", filename, i);
                 params->in_filename = partname.c_str();
                 file_sizes.push_back(insize);
-                lzbench_test_with_params(params, file_sizes, encoder_list?encoder_list:alias_desc[0].params, inbuf, insize, compbuf, comprsize, decomp, rate);
+                lzbench_session_input(s, file_sizes, inbuf, insize, compbuf, comprsize, decomp, rate);
                 file_sizes.clear();
                 insize = fread(inbuf, 1, insize, in);
             }
@@ -701,72 +2622,280 @@ int lzbench_main(lzbench_params_t* params, const char** inFileNames, unsigned if
         else
         {
             file_sizes.push_back(insize);
-            lzbench_test_with_params(params, file_sizes, encoder_list?encoder_list:alias_desc[0].params, inbuf, insize, compbuf, comprsize, decomp, rate);
+            lzbench_session_input(s, file_sizes, inbuf, insize, compbuf, comprsize, decomp, rate);
             file_sizes.clear();
         }
 
-        fclose(in);
-        free(inbuf);
-        free(compbuf);
-        free(decomp);
+        fclose(in);
+        free_buffer(params, inbuf, allocsize + PAD_SIZE);
+        free_buffer(params, compbuf, comprsize);
+        free_buffer(params, decomp, allocsize + PAD_SIZE);
+    }
+    
+    return 0;
+}
+
+
+int lzbench_gen(lzbench_session_t* s)
+{
+    lzbench_params_t* params = &s->params;
+    bench_rate_t rate;
+    bench_timer_t start_ticks, end_ticks;
+    size_t insize, comprsize;
+    uint8_t *inbuf, *compbuf, *decomp;
+    std::vector<size_t> file_sizes;
+    std::string text;
+    uint64_t nanosec;
+
+    insize = params->gen_size;
+    comprsize = GET_COMPRESS_BOUND(insize);
+    inbuf = (uint8_t*)alloc_and_touch(params, insize + PAD_SIZE, false);
+    compbuf = (uint8_t*)alloc_and_touch(params, comprsize, false);
+    decomp = (uint8_t*)alloc_and_touch(params, insize + PAD_SIZE, true);
+
+    if (!inbuf || !compbuf || !decomp)
+    {
+        printf("Not enough memory, please use a smaller size= for --gen!\n");
+        return 1;
+    }
+
+    InitTimer(rate);
+    GetTime(start_ticks);
+    datagen_generate(&params->gen, inbuf, insize);
+    GetTime(end_ticks);
+    nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+    LZBENCH_PRINT(2, "Generated %llu bytes of %s data (seed=%llu) at %.0f MB/s\n", (unsigned long long)insize, params->gen.name, (unsigned long long)params->gen.seed, nanosec ? insize * 1000.0 / nanosec : 0.0);
+
+    format(text, "gen:%s", params->gen.name);
+    params->in_filename = text.c_str();
+    file_sizes.push_back(insize);
+
+    lzbench_session_input(s, file_sizes, inbuf, insize, compbuf, comprsize, decomp, rate);
+
+    free_buffer(params, inbuf, insize + PAD_SIZE);
+    free_buffer(params, compbuf, comprsize);
+    free_buffer(params, decomp, insize + PAD_SIZE);
+
+    return 0;
+}
+
+
+/* --gen=preset[,size=#][,seed=#][,entropy=#][,match=#][,mlen=#][,offset=#][,rep=#] */
+bool parse_gen(lzbench_params_t* params, const char* spec)
+{
+    std::vector<std::string> tokens = split(spec, ',');
+
+    params->gen.seed = 0;
+    if (!datagen_preset(&params->gen, tokens[0].c_str())) return false;
+
+    for (size_t i=1; i<tokens.size(); i++)
+    {
+        size_t eq = tokens[i].find('=');
+        if (eq == std::string::npos) return false;
+        std::string key = tokens[i].substr(0, eq);
+        const char* value = tokens[i].c_str() + eq + 1;
+
+        if (key == "size") params->gen_size = parse_size(value, NULL);
+        else if (key == "seed") params->gen.seed = strtoull(value, NULL, 10);
+        else if (key == "entropy") params->gen.entropy = atof(value);
+        else if (key == "match") params->gen.match = atof(value);
+        else if (key == "mlen") params->gen.mlen = atoi(value);
+        else if (key == "offset")
+        {
+            uint64_t offset = parse_size(value, NULL);
+            if (offset > UINT32_MAX) return false;  // gen.offset is 32-bit
+            params->gen.offset = (uint32_t)offset;
+        }
+        else if (key == "rep") params->gen.rep = atof(value);
+        else return false;
+    }
+    return params->gen_size > 0;
+}
+
+
+/* --compare, the -e list of the baseline rows when no -e is given */
+std::string compare_encoders(const std::vector<compare_row_t>& baseline)
+{
+    std::string list;
+
+    for (size_t i=0; i<baseline.size(); i++)
+    {
+        const std::string& e = baseline[i].encoder;
+        if (e == "memcpy" || e.find('+') != std::string::npos) continue; // always run or run by --checked/--linked
+        if (("/" + list + "/").find("/" + e + "/") != std::string::npos) continue;
+        list += (list.empty() ? "" : "/") + e;
+    }
+    return list;
+}
+
+
+/* prints the changes of the rows that have a baseline row, returns 2 if one is a significant regression, 1 if a row
+   of either side has no match and 0 otherwise */
+int compare_report(lzbench_params_t *params, const std::vector<compare_row_t>& baseline)
+{
+    FILE* out = (params->textformat == CSV || params->textformat == JSON) ? stderr : stdout;
+    double t = params->compare_threshold;
+    int regressions = 0, unmatched = 0;
+    std::vector<bool> matched(baseline.size(), false);
+
+    fprintf(out, "\nComparison with %s (Mann-Whitney U, p < %.2f, threshold %.1f%%):\n", params->compare_file, COMPARE_ALPHA, t);
+    fprintf(out, "Compressor name         Compress.      p      r Decompress.      p      r Compr. size\n");
+    for (size_t i=0; i<params->results.size(); i++)
+    {
+        const string_table_t& row = params->results[i];
+        const compare_row_t* base = NULL;
+        double cp, cr, dp, dr, cchange = 0, dchange = 0, schange;
+        bool worse, better;
+
+        if (row.encoder.empty()) continue;
+        for (size_t j=0; j<baseline.size() && !base; j++)
+            if (baseline[j].encoder == row.encoder && baseline[j].filename == row.col6_filename && baseline[j].block_size == row.col7_chunksize)
+            {
+                base = &baseline[j];
+                matched[j] = true;
+            }
+        if (!base)
+        {
+            fprintf(stderr, "warning: %s (%s, block %llu) has no baseline row\n", row.encoder.c_str(), row.col6_filename.c_str(), (unsigned long long)row.col7_chunksize);
+            unmatched++;
+            continue;
+        }
+
+        uint64_t cbase = compare_median(base->csamples), ccur = compare_median(row.csamples);
+        uint64_t dbase = compare_median(base->dsamples), dcur = compare_median(row.dsamples);
+        if (cbase && ccur) cchange = cbase * 100.0 / ccur - 100.0;  // of the speed, > 0 is faster
+        if (dbase && dcur) dchange = dbase * 100.0 / dcur - 100.0;
+        schange = base->compressed_size ? row.col4_comprsize * 100.0 / base->compressed_size - 100.0 : 0.0;
+        cp = mann_whitney(base->csamples, row.csamples, &cr);
+        dp = mann_whitney(base->dsamples, row.dsamples, &dr);
+
+        worse = (cp < COMPARE_ALPHA && cchange <= -t) || (dp < COMPARE_ALPHA && dchange <= -t) || schange >= t;
+        better = (cp < COMPARE_ALPHA && cchange >= t) || (dp < COMPARE_ALPHA && dchange >= t) || schange <= -t;
+        if (worse) regressions++;
+
+        fprintf(out, "%-22s %+9.1f%% %6.4f %+6.2f %+9.1f%% %6.4f %+6.2f %+10.2f%% %s\n", row.col1_algname.c_str(), cchange, cp, cr,
+            dchange, dp, dr, schange, worse ? "regression" : better ? "improvement" : "");
+    }
+    for (size_t j=0; j<baseline.size(); j++)
+        if (!matched[j] && baseline[j].encoder != "memcpy")  // the memcpy row is not in params->results
+        {
+            fprintf(stderr, "warning: baseline row %s (%s, block %llu) was not run\n", baseline[j].encoder.c_str(), baseline[j].filename.c_str(), (unsigned long long)baseline[j].block_size);
+            unmatched++;
+        }
+    return regressions ? 2 : unmatched ? 1 : 0;
+}
+
+
+/* --roofline, the fastest pass of the kernel over a buffer of the level within one loop time, in MB/s */
+double roofline_measure(int kernel, uint8_t *dst, uint8_t *src, size_t size, bench_rate_t rate)
+{
+    bench_timer_t loop_ticks, start_ticks, end_ticks;
+    uint64_t nanosec, best = 0;
+    size_t passes = MAX(1, (16 << 20) / size);  // at least 16 MB per timing
+    volatile uint64_t sink = 0;
+
+    GetTime(loop_ticks);
+    do
+    {
+        GetTime(start_ticks);
+        for (size_t i=0; i<passes; i++)
+            sink += roofline_run(kernel, dst, src, size);
+        GetTime(end_ticks);
+        nanosec = GetDiffTime(rate, start_ticks, end_ticks);
+        if (!best || nanosec < best) best = nanosec;
+    }
+    while (GetDiffTime(rate, loop_ticks, end_ticks) < DEFAULT_LOOP_TIME);
+
+    return best ? (double)size * passes * 1000.0 / best : 0;
+}
+
+
+/* prints the bandwidths of each level and the decompression speed of each row as a fraction of its bound */
+void roofline_report(lzbench_params_t *params)
+{
+    FILE* out = (params->textformat == CSV || params->textformat == JSON) ? stderr : stdout;
+    double bw[ROOF_LEVELS][ROOF_KERNELS];
+    size_t caches[3];
+    bench_rate_t rate;
+
+    InitTimer(rate);
+    roofline_cache_sizes(caches);
+    fprintf(out, "\nRoofline (one thread, L1 %d KB, L2 %d KB, LLC %d KB):\n", (int)(caches[0] >> 10), (int)(caches[1] >> 10), (int)(caches[2] >> 10));
+    fprintf(out, "%-5s %10s %12s %12s %12s\n", "Level", "Buffer", "Read", "Write", "Copy");
+    for (int level=0; level<ROOF_LEVELS; level++)
+    {
+        size_t size = roofline_level_size(caches, level) & ~(size_t)63;
+        uint8_t *src = (uint8_t*)alloc_and_touch(params, size, false);
+        uint8_t *dst = (uint8_t*)alloc_and_touch(params, size, false);
+
+        memset(bw[level], 0, sizeof(bw[level]));
+        if (src && dst)
+            for (int k=0; k<ROOF_KERNELS; k++)
+            {
+                bw[level][k] = roofline_measure(k, dst, src, size, rate);
+                LZBENCH_PRINT(2, "%s %s %.0f MB/s     \r", roofline_level_names[level], roofline_kernel_names[k], bw[level][k]);
+            }
+        if (src) free_buffer(params, src, size);
+        if (dst) free_buffer(params, dst, size);
+        fprintf(out, "%-5s %7d KB %7d MB/s %7d MB/s %7d MB/s\n", roofline_level_names[level], (int)(size >> 10), (int)bw[level][ROOF_READ],
+            (int)bw[level][ROOF_WRITE], (int)bw[level][ROOF_COPY]);
+    }
+
+    fprintf(out, "%-22s %11s %-5s %12s %9s\n", "Compressor name", "Decompress.", "Level", "Bound", "Of bound");
+    for (size_t i=0; i<params->results.size(); i++)
+    {
+        const string_table_t& row = params->results[i];
+        if (!row.col3_dtime || row.encoder.empty()) continue;
+
+        // each decompression pass reads all compressed chunks and writes the whole output
+        int level = roofline_level(caches, row.col5_origsize + row.col4_comprsize);
+        double rd = bw[level][ROOF_READ], wr = bw[level][ROOF_WRITE];
+        if (!rd || !wr) continue;
+        double bound = row.col5_origsize / (row.col4_comprsize / rd + row.col5_origsize / wr);
+        double dspeed = row.col5_origsize * 1000.0 / row.col3_dtime;
+        fprintf(out, "%-22s %6d MB/s %-5s %7d MB/s %8.1f%% %s\n", row.col1_algname.c_str(), (int)dspeed, roofline_level_names[level], (int)bound,
+            dspeed * 100.0 / bound, (dspeed >= bound * ROOFLINE_MEMORY_BOUND) ? "memory-bound" : "compute-bound");
     }
-    
-    return 0;
 }
 
 
-void usage(lzbench_params_t* params)
+/* liblzbench.h */
+int lzbench_codec_count(void)
 {
-    fprintf(stderr, "usage: " PROGNAME " [options] input [input2] [input3]\n\nwhere [input] is a file or a directory and [options] are:\n");
-    fprintf(stderr, " -b#   set block/chunk size to # KB (default = MIN(filesize,%d KB))\n", (int)(params->chunk_size>>10));
-    fprintf(stderr, " -c#   sort results by column # (1=algname, 2=ctime, 3=dtime, 4=comprsize)\n");
-    fprintf(stderr, " -e#   #=compressors separated by '/' with parameters specified after ',' (deflt=fast)\n");
-    fprintf(stderr, " -iX,Y set min. number of compression and decompression iterations (default = %d, %d)\n", params->c_iters, params->d_iters);
-    fprintf(stderr, " -j    join files in memory but compress them independently (for many small files)\n");
-    fprintf(stderr, " -l    list of available compressors and aliases\n");
-    fprintf(stderr, " -R    read block/chunk size from random blocks (to estimate for large files)\n");
-    fprintf(stderr, " -m#   set memory limit to # MB (default = no limit)\n");
-    fprintf(stderr, " -o#   output text format 1=Markdown, 2=text, 3=text+origSize, 4=CSV (default = %d)\n", params->textformat);
-    fprintf(stderr, " -p#   print time for all iterations: 1=fastest 2=average 3=median (default = %d)\n", params->timetype);
-#ifdef UTIL_HAS_CREATEFILELIST
-    fprintf(stderr, " -r    operate recursively on directories\n");
-#endif
-    fprintf(stderr, " -s#   use only compressors with compression speed over # MB (default = %d MB)\n", params->cspeed);
-    fprintf(stderr, " -tX,Y set min. time in seconds for compression and decompression (default = %.0f, %.0f)\n", params->cmintime/1000.0, params->dmintime/1000.0);
-    fprintf(stderr, " -v    disable progress information\n");
-    fprintf(stderr, " -x    disable real-time process priority\n");
-    fprintf(stderr, " -z    show (de)compression times instead of speed\n");
-    fprintf(stderr,"\nExample usage:\n");
-    fprintf(stderr,"  " PROGNAME " -ezstd filename = selects all levels of zstd\n");
-    fprintf(stderr,"  " PROGNAME " -ebrotli,2,5/zstd filename = selects levels 2 & 5 of brotli and zstd\n");
-    fprintf(stderr,"  " PROGNAME " -t3 -u5 fname = 3 sec compression and 5 sec decompression loops\n");
-    fprintf(stderr,"  " PROGNAME " -t0 -u0 -i3 -j5 -ezstd fname = 3 compression and 5 decompression iter.\n");
-    fprintf(stderr,"  " PROGNAME " -t0u0i3j5 -ezstd fname = the same as above with aggregated parameters\n");
+    int count = 0;
+    for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
+        if (comp_desc[i].compress) count++;
+    return count;
 }
 
 
-int main( int argc, char** argv)
+int lzbench_codec_info(int index, lzbench_codec_info_t* info)
 {
-    FILE *in;
-    char* encoder_list = NULL;
-    int result = 0, sort_col = 0, real_time = 1;
-    lzbench_params_t lzparams;
-    lzbench_params_t* params = &lzparams;
-    const char** inFileNames = (const char**) calloc(argc, sizeof(char*));
-    unsigned ifnIdx=0;
-    bool join = false;
-#ifdef UTIL_HAS_CREATEFILELIST
-    const char** extendedFileList = NULL;
-    char* fileNamesBuf = NULL;
-    unsigned fileNamesNb, recursive=0;
-#endif
+    for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
+        if (comp_desc[i].compress && index-- == 0)
+        {
+            info->name = comp_desc[i].name;
+            info->version = comp_desc[i].version;
+            info->first_level = comp_desc[i].first_level;
+            info->last_level = comp_desc[i].last_level;
+            info->keys = comp_desc[i].keys;
+            return 1;
+        }
+    return 0;
+}
+
+
+void lzbench_bench_defaults(lzbench_bench_options_t* opt)
+{
+    memset(opt, 0, sizeof(lzbench_bench_options_t));
+    opt->ctime_ms = opt->dtime_ms = DEFAULT_LOOP_TIME/1000000;
+}
 
-    if (inFileNames==NULL) {
-        LZBENCH_PRINT(2, "Allocation error : not enough memory%c\n", ' ');
-        return 1;
-    }
 
-    memset(params, 0, sizeof(lzbench_params_t));
+/* the defaults of the command line */
+void lzbench_params_defaults(lzbench_params_t* params)
+{
+    *params = lzbench_params_t();
     params->timetype = FASTEST;
     params->textformat = TEXT;
     params->show_speed = 1;
@@ -777,11 +2906,148 @@ int main( int argc, char** argv)
     params->cmintime = 10*DEFAULT_LOOP_TIME/1000000; // 1 sec
     params->dmintime = 20*DEFAULT_LOOP_TIME/1000000; // 2 sec
     params->cloop_time = params->dloop_time = DEFAULT_LOOP_TIME;
+    params->gen_size = DEFAULT_GEN_SIZE;
+    params->estimate_threshold = DEFAULT_ESTIMATE_THRESHOLD;
+    params->isa = isa_best();
+    params->compare_threshold = COMPARE_DEFAULT_THRESHOLD;
+    params->adaptive_link = ADAPTIVE_DEFAULT_LINK;
+}
 
 
-    while ((argc>1) && (argv[1][0]=='-')) {
-    char* argument = argv[1]+1;
+lzbench_session_t* lzbench_session_new(void)
+{
+    lzbench_session_t* s = new (std::nothrow) lzbench_session_t();
+
+    if (!s) return NULL;
+    lzbench_params_defaults(&s->params);
+    s->real_time = 1;
+    return s;
+}
+
+
+int lzbench_session_option(lzbench_session_t* s, const char* option)
+{
+    lzbench_params_t* params = &s->params;
+
+    if (option[0] != '-') return -1;
+    s->options.push_back(option);
+    char* arg = &s->options.back()[0];  // params points into it
+    char* argument = arg + 1;
+
     if (!strcmp(argument, "-compress-only")) params->compress_only = 1;
+    else if (!strncmp(argument, "-gen=", 5))
+    {
+        if (!parse_gen(params, argument + 5)) { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+    }
+    else if (!strncmp(argument, "-adaptive=", 10))
+    {
+        s->adaptive_list += (s->adaptive_list.empty() ? "" : "/") + std::string(argument + 10);
+        params->adaptive_list = s->adaptive_list.c_str();
+    }
+    else if (!strncmp(argument, "-adaptive-link=", 15))
+        params->adaptive_link = atoi(argument + 15);
+    else if (!strcmp(argument, "-cache")) params->cache_file = RESULT_CACHE_DEFAULT_FILE;
+    else if (!strncmp(argument, "-cache=", 7)) params->cache_file = argument + 7;
+    else if (!strcmp(argument, "-checked")) params->checked = 1;
+    else if (!strcmp(argument, "-cold")) params->cold = 1;
+    else if (!strncmp(argument, "-compare=", 9))
+    {
+        std::vector<std::string> args = split(argument + 9, ',');
+        params->compare_file = argument + 9;
+        if (args.size() > 1)
+        {
+            params->compare_threshold = atof(args.back().c_str());
+            argument[9 + args[0].size()] = 0;
+        }
+    }
+    else if (!strncmp(argument, "-plugin=", 8))
+    {
+        if (!plugin_add(argument + 8)) return 1;
+    }
+    else if (!strcmp(argument, "-literals")) params->entropy_literals = 1;
+    else if (!strcmp(argument, "-mf")) params->mf_list = "all";
+    else if (!strncmp(argument, "-mf=", 4)) params->mf_list = argument + 4;
+    else if (!strcmp(argument, "-parse-stats")) params->parse_stats = 1;
+    else if (!strcmp(argument, "-refresh")) params->cache_refresh = 1;
+    else if (!strcmp(argument, "-roofline")) params->roofline = 1;
+    else if (!strcmp(argument, "-streams")) params->streams = STREAMS_DEFAULT_LIST;
+    else if (!strncmp(argument, "-workload=", 10))
+    {
+        workload_t w;
+        params->workload = argument + 10;
+        if (!workload_parse(params->workload, &w)) { fprintf(stderr, "unknown option or histogram file: %s\n", option); return 1; }
+    }
+    else if (!strncmp(argument, "-streams=", 9))
+    {
+        std::vector<unsigned> counts;
+        params->streams = argument + 9;
+        if (!streams_parse(params->streams, counts)) { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+    }
+    else if (!strcmp(argument, "-inplace")) params->inplace = 1;
+    else if (!strcmp(argument, "-linked")) params->linked = 1;
+    else if (!strcmp(argument, "-zstd-search")) params->zstd_search = "3";
+    else if (!strncmp(argument, "-zstd-search=", 13)) params->zstd_search = argument + 13;
+    else if (!strcmp(argument, "-adversarial")) { params->adversarial = 1; params->adversarial_trials = ADVERSARIAL_DEFAULT_TRIALS; }
+    else if (!strncmp(argument, "-adversarial=", 13))
+    {
+        char* end;
+        unsigned long long trials = strtoull(argument + 13, &end, 10);
+        if (argument[13] < '0' || argument[13] > '9' || *end || !trials || trials > UINT32_MAX) { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+        params->adversarial = 1;
+        params->adversarial_trials = (uint32_t)trials;
+    }
+    else if (!strncmp(argument, "-isa=", 5))
+    {
+        std::vector<std::string> names = split(argument + 5, ',');
+        params->isa_list = (strcmp(argument + 5, "auto")) ? argument + 5 : NULL;
+        for (size_t k=0; params->isa_list && k<names.size(); k++)
+            if (!isa_available(isa_find(names[k].c_str())))
+            {
+                fprintf(stderr, "instruction set not built or not supported by this CPU: %s\n", names[k].c_str());
+                return 1;
+            }
+    }
+    else if (!strncmp(argument, "-block-sweep=", 13))
+    {
+        const char* end;
+        params->sweep_min = parse_size(argument + 13, &end);
+        params->sweep_max = (end[0] == '.' && end[1] == '.') ? parse_size(end + 2, &end) : params->sweep_min;
+        if (!params->sweep_min || params->sweep_max < params->sweep_min || *end ||
+            (params->sweep_min & (params->sweep_min - 1)) || (params->sweep_max & (params->sweep_max - 1))) { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+    }
+    else if (!strncmp(argument, "-estimate=", 10))
+    {
+        std::vector<std::string> tokens = split(argument + 10, ',');
+        for (int i=EST_ENTROPY; i<=EST_LZ4; i++)
+            if (tokens[0] == estimator_names[i]) params->estimator = (estimator_e)i;
+        if (tokens.size() > 1)
+        {
+            char* end;
+            long threshold = strtol(tokens[1].c_str(), &end, 10);
+            if (end == tokens[1].c_str() || *end || threshold < 0 || threshold > 100) params->estimator = EST_NONE;
+            else params->estimate_threshold = threshold;
+        }
+        if (!params->estimator || tokens.size() > 2) { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+    }
+    else if (!strncmp(argument, "-huge=", 6))
+    {
+        if (!strcmp(argument + 6, "thp")) params->huge_pages = HUGE_THP;
+        else if (!strcmp(argument + 6, "tlb")) params->huge_pages = HUGE_TLB;
+        else { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+    }
+    else if (!strncmp(argument, "-numa=", 6))
+    {
+        if (!strcmp(argument + 6, "interleave")) params->numa_policy = NUMA_INTERLEAVE;
+        else if (argument[6] >= '0' && argument[6] <= '9' && atoi(argument + 6) < 64) { params->numa_policy = NUMA_BIND; params->numa_node = atoi(argument + 6); }
+        else { fprintf(stderr, "unknown option: %s\n", option); return 1; }
+#ifdef LZBENCH_HAS_MMAP
+        if (params->numa_policy == NUMA_BIND && !((numa_online_nodes() >> params->numa_node) & 1))
+        {
+            fprintf(stderr, "--numa=%d: NUMA node %d is not online\n", params->numa_node, params->numa_node);
+            return 1;
+        }
+#endif
+    }
     else while (argument[0] != 0) {
         char* numPtr = argument + 1;
         unsigned number = 0;
@@ -792,10 +3058,18 @@ int main( int argc, char** argv)
             params->chunk_size = number << 10;
             break;
         case 'c':
-            sort_col = number;
+            s->sort_col = number;
             break;
         case 'e':
-            encoder_list = strdup(argument + 1);
+            s->encoders = argument + 1;
+            numPtr += strlen(numPtr);
+            break;
+        case 'E':
+            params->entropy_list = (argument[1]) ? argument + 1 : "all";
+            numPtr += strlen(numPtr);
+            break;
+        case 'H':
+            params->checksum_list = (argument[1]) ? argument + 1 : "all";
             numPtr += strlen(numPtr);
             break;
         case 'i':
@@ -809,7 +3083,7 @@ int main( int argc, char** argv)
             }
             break;
         case 'j':
-            join = true;
+            s->join = 1;
             break;
         case 'm':
             params->mem_limit = number << 18; /*  total memory usage = mem_limit * 4  */
@@ -817,14 +3091,14 @@ int main( int argc, char** argv)
             break;
         case 'o':
             params->textformat = (textformat_e)number;
-            if (params->textformat == CSV) params->verbose = 0;
+            if (params->textformat == CSV || params->textformat == JSON) params->verbose = 0;
             break;
         case 'p':
             params->timetype = (timetype_e)number;
             break;
 #ifdef UTIL_HAS_CREATEFILELIST
         case 'r':
-            recursive = 1;
+            s->recursive = 1;
             break;
 #endif
         case 'R':
@@ -854,79 +3128,165 @@ int main( int argc, char** argv)
             params->verbose = number;
             break;
         case 'x':
-            real_time = 0;
+            s->real_time = 0;
             break;
         case 'z':
             params->show_speed = 0;
             break;
-        case '-': // --help
-        case 'h':
-            usage(params);
-            goto _clean;
-        case 'l':
-            printf("\nAvailable compressors for -e option:\n");
-            printf("all - alias for all available compressors\n");
-            printf("fast - alias for compressors with compression speed over 100 MB/s (default)\n");
-            printf("opt - compressors with optimal parsing (slow compression, fast decompression)\n");
-            printf("lzo / ucl - aliases for all levels of given compressors\n");
-            for (int i=1; i<LZBENCH_COMPRESSOR_COUNT; i++)
-            {
-                if (comp_desc[i].compress)
-                {
-                    if (comp_desc[i].first_level < comp_desc[i].last_level)
-                        printf("%s %s [%d-%d]\n", comp_desc[i].name, comp_desc[i].version, comp_desc[i].first_level, comp_desc[i].last_level);
-                    else
-                        printf("%s %s\n", comp_desc[i].name, comp_desc[i].version);
-                }
-            }
-            return 0;
         default:
-            fprintf(stderr, "unknown option: %s\n", argv[1]);
-            result = 1; goto _clean;
+            if (argument == arg + 1) return -1; // -h, -l and the unknown ones are left to the caller
+            fprintf(stderr, "unknown option: %s\n", option);
+            return 1;
         }
         argument = numPtr;
     }
-    argv++;
-    argc--;
+    return 0;
+}
+
+
+/* loads --compare, opens --cache and picks the default -e list before the first input */
+int lzbench_session_start(lzbench_session_t* s)
+{
+    lzbench_params_t* params = &s->params;
+    std::string text;
+    bool adaptive_valid;
+
+    LZBENCH_PRINT(2, PROGNAME " " PROGVERSION " (%d-bit " PROGOS ")   Assembled by P.Skibinski\n", (uint32_t)(8 * sizeof(uint8_t*)));
+    if (params->huge_pages || params->numa_policy)
+    {
+        if (params->numa_policy == NUMA_BIND) format(text, "node %d", params->numa_node);
+        else text = (params->numa_policy == NUMA_INTERLEAVE) ? "interleave" : "default";
+        LZBENCH_PRINT(2, "Buffers: huge pages=%s NUMA=%s\n", (params->huge_pages == HUGE_TLB) ? "MAP_HUGETLB" : (params->huge_pages == HUGE_THP) ? "THP" : "off", text.c_str());
     }
+    LZBENCH_PRINT(5, "params: chunk_size=%d c_iters=%d d_iters=%d cspeed=%d cmintime=%d dmintime=%d encoder_list=%s\n", (int)params->chunk_size, params->c_iters, params->d_iters, params->cspeed, params->cmintime, params->dmintime, s->encoders);
 
-    while (argc > 1) {
-        inFileNames[ifnIdx++] = argv[1];
-        argv++;
-        argc--;
+    if ((params->checksum_list || params->entropy_list || params->mf_list || params->zstd_search) && !s->encoders) s->encoders = ""; // only checksums, entropy coders, match finders or the search
+
+    global_state_lock.lock();
+    adaptive_valid = adaptive_apply(params); // after all --plugin options
+    global_state_lock.unlock();
+    if (!adaptive_valid)
+    {
+        fprintf(stderr, "unknown option: --adaptive=%s\n", s->adaptive_list.c_str());
+        return 1;
     }
 
-    LZBENCH_PRINT(2, PROGNAME " " PROGVERSION " (%d-bit " PROGOS ")   Assembled by P.Skibinski\n", (uint32_t)(8 * sizeof(uint8_t*)));
-    LZBENCH_PRINT(5, "params: chunk_size=%d c_iters=%d d_iters=%d cspeed=%d cmintime=%d dmintime=%d encoder_list=%s\n", (int)params->chunk_size, params->c_iters, params->d_iters, params->cspeed, params->cmintime, params->dmintime, encoder_list);
+    if (params->compare_file)
+    {
+        if (!compare_load(params->compare_file, s->baseline)) { fprintf(stderr, "%s: no rows of -o7 with encoders\n", params->compare_file); return 1; }
+        if (params->cache_file) { fprintf(stderr, "--compare can't be used with --cache, a cached row has a single sample\n"); return 1; }
+        if (!s->encoders)
+        {
+            s->options.push_back(compare_encoders(s->baseline));
+            s->encoders = s->options.back().c_str();
+        }
+    }
+    if (!s->encoders) s->encoders = alias_desc[0].params;
 
-    if (ifnIdx < 1)  { usage(params); goto _clean; }
+    if (params->cache_file)
+    {
+        params->cache = new result_cache_t();
+        params->cache->refresh = params->cache_refresh;
+        if (!find_checksum("xxh64")) { fprintf(stderr, "--cache needs xxh64 of zstd\n"); return 1; }
+        if (!cache_open(params->cache, params->cache_file, params->isa)) { perror(params->cache_file); return 1; }
+        format(params->cache->timing, "p%d t%u,%u u%u,%u i%u,%u", (int)params->timetype, params->cmintime, params->dmintime,
+            params->cloop_time, params->dloop_time, params->c_iters, params->d_iters);
+    }
 
-    if (real_time)
+    if (s->real_time)
     {
         SET_HIGH_PRIORITY;
     } else {
         LZBENCH_PRINT(2, "The real-time process priority disabled%c\n", ' ');
     }
 
+    s->started = 1;
+    return 0;
+}
+
+
+int lzbench_session_bench(lzbench_session_t* s, const void* data, size_t size, const char* name)
+{
+    lzbench_params_t* params = &s->params;
+    bench_rate_t rate;
+    std::vector<size_t> file_sizes(1, size);
+    size_t comprsize = GET_COMPRESS_BOUND(size);
+    uint8_t *inbuf, *compbuf, *decomp;
+
+    if (!s->started && lzbench_session_start(s)) return 1;
+
+    inbuf = (uint8_t*)alloc_and_touch(params, size + PAD_SIZE, false);
+    compbuf = (uint8_t*)alloc_and_touch(params, comprsize, false);
+    decomp = (uint8_t*)alloc_and_touch(params, size + PAD_SIZE, true);
+    if (!inbuf || !compbuf || !decomp)
+    {
+        if (inbuf) free_buffer(params, inbuf, size + PAD_SIZE);
+        if (compbuf) free_buffer(params, compbuf, comprsize);
+        if (decomp) free_buffer(params, decomp, size + PAD_SIZE);
+        if (!params->quiet) printf("Not enough memory!\n");
+        return 1;
+    }
+    memcpy(inbuf, data, size);
+    params->in_filename = name;
+
+    InitTimer(rate);
+    lzbench_session_input(s, file_sizes, inbuf, size, compbuf, comprsize, decomp, rate);
+
+    free_buffer(params, inbuf, size + PAD_SIZE);
+    free_buffer(params, compbuf, comprsize);
+    free_buffer(params, decomp, size + PAD_SIZE);
+    return 0;
+}
+
+
+int lzbench_session_run(lzbench_session_t* s, const char* const* files, size_t count)
+{
+    lzbench_params_t* params = &s->params;
+    const char** inFileNames = (const char**)files;
+    unsigned ifnIdx = (unsigned)count;
+    int result;
+#ifdef UTIL_HAS_CREATEFILELIST
+    const char** extendedFileList = NULL;
+    char* fileNamesBuf = NULL;
+    unsigned fileNamesNb;
+#endif
+
+    if (!count && !params->gen.name) return -1;
+    if (!s->started && lzbench_session_start(s)) return 1;
 
 #ifdef UTIL_HAS_CREATEFILELIST
-    if (recursive) {  /* at this stage, filenameTable is a list of paths, which can contain both files and directories */ 
+    if (s->recursive) {  /* at this stage, filenameTable is a list of paths, which can contain both files and directories */
         extendedFileList = UTIL_createFileList(inFileNames, ifnIdx, &fileNamesBuf, &fileNamesNb);
         if (extendedFileList) {
             unsigned u;
             for (u=0; u<fileNamesNb; u++) LZBENCH_PRINT(4, "%u %s\n", u, extendedFileList[u]);
-            free((void*)inFileNames);
             inFileNames = extendedFileList;
             ifnIdx = fileNamesNb;
         }
     }
 #endif
 
-    /* Main function */
-    if (join)
-        result = lzbench_join(params, inFileNames, ifnIdx, encoder_list);
+    if (params->gen.name)
+        result = lzbench_gen(s);
+    else if (s->join)
+        result = lzbench_join(s, inFileNames, ifnIdx);
     else
-        result = lzbench_main(params, inFileNames, ifnIdx, encoder_list);
+        result = lzbench_main(s, inFileNames, ifnIdx);
+
+#ifdef UTIL_HAS_CREATEFILELIST
+    if (extendedFileList)
+        UTIL_freeFileList(extendedFileList, fileNamesBuf);
+#endif
+    return result;
+}
+
+
+int lzbench_session_finish(lzbench_session_t* s)
+{
+    lzbench_params_t* params = &s->params;
+    int result = 0;
+
+    if (!s->started) return 0;
 
     if (params->chunk_size > 10 * (1<<20)) {
         LZBENCH_PRINT(2, "done... (cIters=%d dIters=%d cTime=%.1f dTime=%.1f chunkSize=%dMB cSpeed=%dMB)\n", params->c_iters, params->d_iters, params->cmintime/1000.0, params->dmintime/1000.0, (int)(params->chunk_size >> 20), params->cspeed);
@@ -934,12 +3294,21 @@ int main( int argc, char** argv)
         LZBENCH_PRINT(2, "done... (cIters=%d dIters=%d cTime=%.1f dTime=%.1f chunkSize=%dKB cSpeed=%dMB)\n", params->c_iters, params->d_iters, params->cmintime/1000.0, params->dmintime/1000.0, (int)(params->chunk_size >> 10), params->cspeed);
     }
 
-    if (sort_col <= 0) goto _clean;
+    if (params->cache)
+        LZBENCH_PRINT(2, "cache %s: %u results reused, %u measured\n", params->cache_file, params->cache->hits, params->cache->misses);
+
+    if (params->roofline)
+        roofline_report(params);
+
+    if (!s->baseline.empty())
+        result = compare_report(params, s->baseline);
 
-    printf("\nThe results sorted by column number %d:\n", sort_col);
+    if (s->sort_col <= 0) return result;
+
+    printf("\nThe results sorted by column number %d:\n", s->sort_col);
     print_header(params);
 
-    switch (sort_col)
+    switch (s->sort_col)
     {
         default:
         case 1: std::sort(params->results.begin(), params->results.end(), less_using_1st_column()); break;
@@ -956,14 +3325,221 @@ int main( int argc, char** argv)
         else
             print_time(params, *it);
     }
+    return result;
+}
 
-_clean:
-    if (encoder_list) free(encoder_list);
+
+int lzbench_session_results(lzbench_session_t* s, lzbench_result_t* results, size_t max_results)
+{
+    for (size_t i=0; i<s->params.results.size() && i<max_results; i++)
+    {
+        const string_table_t& row = s->params.results[i];
+        lzbench_result_t* r = &results[i];
+
+        if (row.col1_algname.size() >= sizeof(r->name) || row.encoder.size() >= sizeof(r->encoder)) return -2;
+        strcpy(r->name, row.col1_algname.c_str());
+        strcpy(r->encoder, row.encoder.c_str());
+        r->insize = row.col5_origsize;
+        r->outsize = row.col4_comprsize;
+        r->ctime_ns = row.col2_ctime;
+        r->dtime_ns = row.col3_dtime;
+        r->cspeed = row.col2_ctime ? row.col5_origsize * 1000.0 / row.col2_ctime : 0.0;
+        r->dspeed = row.col3_dtime ? row.col5_origsize * 1000.0 / row.col3_dtime : 0.0;
+    }
+    return (int)s->params.results.size();
+}
+
+
+void lzbench_session_free(lzbench_session_t* s)
+{
+    if (!s) return;
+    if (s->params.cache)
+    {
+        cache_close(s->params.cache);
+        delete s->params.cache;
+    }
+    delete s;
+}
+
+
+int lzbench_bench(const char* encoders, const void* data, size_t size, const lzbench_bench_options_t* opt,
+                  lzbench_result_t* results, size_t max_results)
+{
+    lzbench_session_t* s = lzbench_session_new();
+    lzbench_params_t* params;
+    int count = -1;
+
+    if (!s) return -1;
+    params = &s->params;
+    params->quiet = 1;
+    params->verbose = 0;
+    params->compress_only = opt->compress_only;
+    params->chunk_size = opt->chunk_size ? opt->chunk_size : size;
+    params->cspeed = opt->min_cspeed;
+    params->cmintime = opt->ctime_ms;
+    params->dmintime = opt->dtime_ms;
+    params->cloop_time = MIN(DEFAULT_LOOP_TIME, opt->ctime_ms * 1000000ULL);
+    params->dloop_time = MIN(DEFAULT_LOOP_TIME, opt->dtime_ms * 1000000ULL);
+    s->encoders = encoders;
+    s->real_time = 0;
+
+    if (!lzbench_session_bench(s, data, size, ""))
+        count = lzbench_session_results(s, results, max_results);
+    lzbench_session_free(s);
+    return count;
+}
+
+
+#ifndef LZBENCH_LIBRARY  // liblzbench has the API above instead of the command line
+void usage()
+{
+    lzbench_params_t defaults;
+    lzbench_params_t* params = &defaults;
+
+    lzbench_params_defaults(params);
+    fprintf(stderr, "usage: " PROGNAME " [options] input [input2] [input3]\n\nwhere [input] is a file or a directory and [options] are:\n");
+    fprintf(stderr, " -b#   set block/chunk size to # KB (default = MIN(filesize,%d KB))\n", (int)(params->chunk_size>>10));
+    fprintf(stderr, " -c#   sort results by column # (1=algname, 2=ctime, 3=dtime, 4=comprsize)\n");
+    fprintf(stderr, " -e#   #=compressors separated by '/' with parameters specified after ',' (deflt=fast)\n");
+    fprintf(stderr, " -E#   #=order-0 entropy coders separated by ',' (deflt=all), e.g. huf,huf1x,fse,fse_lzfse\n");
+    fprintf(stderr, " -H#   #=checksums separated by ',' (deflt=all), combined with -e also prints codec + checksum\n");
+    fprintf(stderr, " -iX,Y set min. number of compression and decompression iterations (default = %d, %d)\n", params->c_iters, params->d_iters);
+    fprintf(stderr, " -j    join files in memory but compress them independently (for many small files)\n");
+    fprintf(stderr, " -l    list of available compressors and aliases\n");
+    fprintf(stderr, " -R    read block/chunk size from random blocks (to estimate for large files)\n");
+    fprintf(stderr, " -m#   set memory limit to # MB (default = no limit)\n");
+    fprintf(stderr, " -o#   output text format 1=Markdown, 2=text, 3=text+origSize, 4=CSV, 7=JSON (default = %d)\n", params->textformat);
+    fprintf(stderr, " -p#   print time for all iterations: 1=fastest 2=average 3=median (default = %d)\n", params->timetype);
 #ifdef UTIL_HAS_CREATEFILELIST
-    if (extendedFileList)
-        UTIL_freeFileList(extendedFileList, fileNamesBuf);
-    else
+    fprintf(stderr, " -r    operate recursively on directories\n");
 #endif
+    fprintf(stderr, " -s#   use only compressors with compression speed over # MB (default = %d MB)\n", params->cspeed);
+    fprintf(stderr, " -tX,Y set min. time in seconds for compression and decompression (default = %.0f, %.0f)\n", params->cmintime/1000.0, params->dmintime/1000.0);
+    fprintf(stderr, " -v    disable progress information\n");
+    fprintf(stderr, " -x    disable real-time process priority\n");
+    fprintf(stderr, " -z    show (de)compression times instead of speed\n");
+    fprintf(stderr, " --compress-only  benchmark only compression\n");
+    fprintf(stderr, " --gen=preset[,size=#][,seed=#][,entropy=#][,match=#][,mlen=#][,offset=#][,rep=#]\n");
+    fprintf(stderr, "                  benchmark generated data instead of input files, presets: " DATAGEN_PRESETS "\n");
+    fprintf(stderr, " --adversarial[=#]  decode worst-case inputs and # mutated streams per mutation (default = %d)\n", ADVERSARIAL_DEFAULT_TRIALS);
+    fprintf(stderr, " --adaptive=name[,level]/...  candidates of the adaptive pseudo-codec, fastest first (default = %s)\n", ADAPTIVE_DEFAULT_CANDIDATES);
+    fprintf(stderr, " --adaptive-link=#  link speed in MB/s assumed by the adaptive cost model (default = %d)\n", ADAPTIVE_DEFAULT_LINK);
+    fprintf(stderr, " --block-sweep=#..#  run all compressors with each power-of-two block size in the range, e.g. 4K..16M\n");
+    fprintf(stderr, " --cache[=#]      reuse the results of earlier runs stored in file # (default = " RESULT_CACHE_DEFAULT_FILE ")\n");
+    fprintf(stderr, " --checked        also run each compressor with its native checksum (zstd, libdeflate) or XXH64\n");
+    fprintf(stderr, " --cold           time init, the first call in a fresh context and a warm call for the first chunk\n");
+    fprintf(stderr, " --compare=#[,#]  compare with the -o7 output # and fail if a row is significantly # %% worse (default = %.0f%%)\n", COMPARE_DEFAULT_THRESHOLD);
+    fprintf(stderr, " --estimate=entropy|hist|lz4[,#]  store chunks with estimated ratio over #%% (0-100) uncompressed (default = %d%%)\n", DEFAULT_ESTIMATE_THRESHOLD);
+    fprintf(stderr, " --huge=thp|tlb   back buffers with transparent (madvise) or explicit (MAP_HUGETLB) huge pages\n");
+    fprintf(stderr, " --inplace        decode lz4, zstd and lzsse with the compressed data at the tail of the output buffer\n");
+    fprintf(stderr, " --isa=auto|base,avx2,avx512  instruction set variants of lz4, lizard, zstd, libdeflate, snappy, brotli,\n");
+    fprintf(stderr, "                  lzsse to run (default = auto = %s)\n", isa_names[isa_best()]);
+    fprintf(stderr, " --linked         also compress the chunks of -b as one stream (lz4, lz4hc, zstd, zlib, brotli)\n");
+    fprintf(stderr, " --literals       with -E, entropy-code the literals of an lz4 pass over each chunk instead of the input\n");
+    fprintf(stderr, " --mf[=#]         run the match finders separated by ',' alone (default = all), e.g. lzma_bt4,libdeflate_hc\n");
+    fprintf(stderr, " --numa=#         bind buffers to NUMA node # (--numa=interleave spreads them over all nodes)\n");
+    fprintf(stderr, " --parse-stats    print literal/match counts and length/offset histograms of lz4, lz4fast, lz4hc, zstd\n");
+    fprintf(stderr, " --plugin=#       load the compressors and aliases of codec plugin # (see lzbench_plugin.h), can repeat\n");
+    fprintf(stderr, " --refresh        with --cache, measure all compressors again and update their results\n");
+    fprintf(stderr, " --roofline       measure read/write/copy bandwidth of L1, L2, LLC and DRAM and relate decompression to it\n");
+    fprintf(stderr, " --streams[=#]    also send the chunks round-robin to each number of contexts in # (default = " STREAMS_DEFAULT_LIST ")\n");
+    fprintf(stderr, " --workload=lognormal[,median=#][,sigma=#]|hist=file[,min=#][,max=#][,rate=#][,count=#][,seed=#]\n");
+    fprintf(stderr, "                  also run # requests of random sizes, open loop at # requests/s or closed loop (rate=0)\n");
+    fprintf(stderr, " --zstd-search=#[,#]  search zstd_adv parameters around level # for the Pareto front above # MB/s\n");
+    fprintf(stderr,"\nExample usage:\n");
+    fprintf(stderr,"  " PROGNAME " -ezstd filename = selects all levels of zstd\n");
+    fprintf(stderr,"  " PROGNAME " -ebrotli,2,5/zstd filename = selects levels 2 & 5 of brotli and zstd\n");
+    fprintf(stderr,"  " PROGNAME " -t3 -u5 fname = 3 sec compression and 5 sec decompression loops\n");
+    fprintf(stderr,"  " PROGNAME " -t0 -u0 -i3 -j5 -ezstd fname = 3 compression and 5 decompression iter.\n");
+    fprintf(stderr,"  " PROGNAME " -t0u0i3j5 -ezstd fname = the same as above with aggregated parameters\n");
+    fprintf(stderr,"  " PROGNAME " --gen=json,size=1G,seed=7 -ezstd,3 = 1 GB of generated JSON-like data\n");
+    fprintf(stderr,"  " PROGNAME " -ezstd_adv,19,wlog=23,strat=btultra fname = zstd level 19 with two parameters overridden\n");
+}
+
+
+/* -l */
+void list_compressors()
+{
+    printf("\nAvailable compressors for -e option:\n");
+    printf("all - alias for all available compressors\n");
+    printf("fast - alias for compressors with compression speed over 100 MB/s (default)\n");
+    printf("opt - compressors with optimal parsing (slow compression, fast decompression)\n");
+    printf("lzo / ucl - aliases for all levels of given compressors\n");
+    for (size_t i=0; i<plugin_aliases.size(); i++)
+        printf("%s - alias for %s\n", plugin_aliases[i].name, plugin_aliases[i].params);
+    for (int i=1; i<LZBENCH_COMPRESSOR_COUNT + (int)plugin_codecs.size(); i++)
+    {
+        const compressor_desc_t* desc = (i < LZBENCH_COMPRESSOR_COUNT) ? &comp_desc[i] : &plugin_codecs[i - LZBENCH_COMPRESSOR_COUNT];
+        if (desc->compress)
+        {
+            if (desc->first_level < desc->last_level)
+                printf("%s %s [%d-%d]", desc->name, desc->version, desc->first_level, desc->last_level);
+            else
+                printf("%s %s", desc->name, desc->version);
+            if (desc->keys)
+                printf(" keys: %s", desc->keys);
+            printf("\n");
+        }
+    }
+    printf("\nAvailable checksums for -H option:\n");
+    printf("all - alias for all available checksums\n");
+    for (int i=0; i<checksum_desc_count; i++)
+        printf("%s %s\n", checksum_desc[i].name, checksum_desc[i].version);
+    printf("\nAvailable entropy coders for -E option:\n");
+    printf("all - alias for all available entropy coders\n");
+    for (int i=0; i<entropy_desc_count; i++)
+        printf("%s %s (%d stream%s)\n", entropy_desc[i].name, entropy_desc[i].version, entropy_desc[i].streams, (entropy_desc[i].streams > 1) ? "s" : "");
+    printf("\nAvailable match finders for --mf option:\n");
+    printf("all - alias for all available match finders\n");
+    for (int i=0; i<mf_desc_count; i++)
+        printf("%s %s (%s)\n", mf_desc[i].name, mf_desc[i].version, mf_desc[i].params);
+}
+
+
+int main( int argc, char** argv)
+{
+    lzbench_session_t* session = lzbench_session_new();
+    const char** inFileNames = (const char**) calloc(argc, sizeof(char*));
+    unsigned ifnIdx=0;
+    int result = 0, option, finished;
+
+    if (!session || !inFileNames) {
+        fprintf(stderr, "Allocation error : not enough memory\n");
+        lzbench_session_free(session);
         free((void*)inFileNames);
+        return 1;
+    }
+
+    while ((argc>1) && (argv[1][0]=='-')) {
+        option = lzbench_session_option(session, argv[1]);
+        if (option > 0) { result = 1; goto _clean; }
+        if (option < 0)
+        {
+            if (argv[1][1] == 'l') { list_compressors(); goto _clean; }
+            if (argv[1][1] == 'h' || argv[1][1] == '-') { usage(); goto _clean; } // -h, --help
+            fprintf(stderr, "unknown option: %s\n", argv[1]);
+            result = 1; goto _clean;
+        }
+        argv++;
+        argc--;
+    }
+
+    while (argc > 1) {
+        inFileNames[ifnIdx++] = argv[1];
+        argv++;
+        argc--;
+    }
+
+    result = lzbench_session_run(session, inFileNames, ifnIdx);
+    if (result < 0) { result = 0; usage(); goto _clean; } // no input files and no --gen
+
+    finished = lzbench_session_finish(session);
+    if (!result) result = finished;
+
+_clean:
+    lzbench_session_free(session);
+    free((void*)inFileNames);
     return result;
 }
+
+#endif
@@ -6,14 +6,36 @@
 
 #include <vector>
 #include <string>
+#include <list>
 #include "compressors.h"
+#include "datagen.h"
+#include "adaptive.h"
+#include "checksums.h"
+#include "entropy.h"
+#include "matchfinder.h"
+#include "adversarial.h"
+#include "zstd_search.h"
+#include "plugin.h"
+#include "liblzbench.h"
+#include "result_cache.h"
+#include "compare.h"
+#include "roofline.h"
+#include "streams.h"
+#include "workload.h"
+#include "isa.h"
 #include "lizard/lizard_compress.h"    // LIZARD_MAX_CLEVEL
 
 #define PROGNAME "lzbench"
 #define PROGVERSION "1.8"
 #define PAD_SIZE (16*1024)
 #define MIN_PAGE_SIZE 4096  // smallest page size we expect, if it's wrong the first algorithm might be a bit slower
+#define HUGE_PAGE_SIZE (2*1024*1024)  // default huge page size if /proc/meminfo doesn't tell
 #define DEFAULT_LOOP_TIME (100*1000000)  // 1/10 of a second
+#define DEFAULT_GEN_SIZE (64*1024*1024)
+#define DEFAULT_ESTIMATE_THRESHOLD 95  // chunks with estimated ratio over 95% are stored uncompressed
+#define ESTIMATE_SAMPLE_SIZE (16*1024)  // bytes sampled by the entropy and histogram estimators
+#define ESTIMATE_LZ4_BLOCK (4*1024)  // the lz4 probe compresses up to 4 such blocks
+#define ADAPTIVE_DEFAULT_CANDIDATES "lz4/zstd,3/zstd,12"  // ordered from the fastest
 #define GET_COMPRESS_BOUND(insize) (insize + insize/6 + PAD_SIZE)  // for pithy
 #define LZBENCH_PRINT(level, fmt, ...) if (params->verbose >= level) printf(fmt, __VA_ARGS__)
 
@@ -85,25 +107,82 @@ typedef struct string_table
     std::string col1_algname;
     uint64_t col2_ctime, col3_dtime, col4_comprsize, col5_origsize;
     std::string col6_filename;
-    string_table(std::string c1, uint64_t c2, uint64_t c3, uint64_t c4, uint64_t c5, std::string filename) : col1_algname(c1), col2_ctime(c2), col3_dtime(c3), col4_comprsize(c4), col5_origsize(c5), col6_filename(filename) {}
+    uint64_t col7_chunksize;
+    std::string encoder;   // the -e argument of a compressor row
+    std::vector<uint64_t> csamples, dsamples;  // the average time of each timing loop
+    string_table(std::string c1, uint64_t c2, uint64_t c3, uint64_t c4, uint64_t c5, std::string filename, uint64_t c7 = 0) : col1_algname(c1), col2_ctime(c2), col3_dtime(c3), col4_comprsize(c4), col5_origsize(c5), col6_filename(filename), col7_chunksize(c7) {}
 } string_table_t;
 
-enum textformat_e { MARKDOWN=1, TEXT, TEXT_FULL, CSV, TURBOBENCH, MARKDOWN2 };
+enum textformat_e { MARKDOWN=1, TEXT, TEXT_FULL, CSV, TURBOBENCH, MARKDOWN2, JSON };
 enum timetype_e { FASTEST=1, AVERAGE, MEDIAN };
+enum hugepages_e { HUGE_NONE=0, HUGE_THP, HUGE_TLB };
+enum numa_e { NUMA_DEFAULT=0, NUMA_BIND, NUMA_INTERLEAVE };
+enum estimator_e { EST_NONE=0, EST_ENTROPY, EST_HIST, EST_LZ4 };
 
 typedef struct
 {
     int show_speed, compress_only;
     timetype_e timetype;
     textformat_e textformat;
-    size_t chunk_size;
+    size_t chunk_size, sweep_min, sweep_max;
     uint32_t c_iters, d_iters, cspeed, verbose, cmintime, dmintime, cloop_time, dloop_time;
     size_t mem_limit;
     int random_read;
+    hugepages_e huge_pages;
+    numa_e numa_policy;
+    int numa_node;
+    datagen_params_t gen;
+    uint64_t gen_size;
+    estimator_e estimator;
+    uint32_t estimate_threshold;
+    const char* checksum_list;
+    const char* entropy_list;
+    int entropy_literals;  // --literals, -E codes the literals of an lz4 pass
+    const char* mf_list;   // --mf list of match finders
+    int parse_stats;
+    int adversarial;
+    uint32_t adversarial_trials;  // mutated streams per mutation
+    int inplace;
+    int linked;
+    const char* zstd_search;  // --zstd-search level[,MB/s]
+    void (*linked_run)(char* workmem);  // the reset of the stream while the --linked variant runs, called at each pass;
+                                        // its chunks are never stored as the next ones depend on them
+    int checked;
+    int cold;              // --cold
+    const char* streams;   // --streams list of context counts
+    const char* workload;  // --workload spec
+    int quiet;             // set by the liblzbench API, rows are only collected in results
+    const char* cache_file;   // --cache
+    int cache_refresh;        // --refresh
+    result_cache_t* cache;
+    uint64_t input_hash;      // XXH64 of the input of the rows, for the cache keys
+    const char* compare_file; // --compare baseline
+    double compare_threshold;
+    int roofline;             // --roofline
+    int isa;               // isa_e of the codecs with variants
+    const char* isa_list;  // --isa list, the ISA is appended to the version
+    const char* adaptive_list;  // --adaptive candidates, NULL = ADAPTIVE_DEFAULT_CANDIDATES
+    uint32_t adaptive_link;     // --adaptive-link
     std::vector<string_table_t> results;
     const char* in_filename;
 } lzbench_params_t;
 
+/* lzbench_session_t of liblzbench.h, the state of a command line run */
+struct lzbench_session
+{
+    lzbench_params_t params;
+    std::list<std::string> options;  // the option strings params points into
+    std::string adaptive_list;
+    std::vector<compare_row_t> baseline;
+    const char* encoders;  // -e, NULL until the session starts = the default
+    int sort_col;          // -c
+    int real_time;         // not -x
+    int join;              // -j
+    int recursive;         // -r
+    int started;           // the first input loaded --compare and opened --cache
+    size_t inputs;         // benchmarked so far, the first one prints the header and memcpy
+};
+
 struct less_using_1st_column { inline bool operator() (const string_table_t& struct1, const string_table_t& struct2) {  return (struct1.col1_algname < struct2.col1_algname); } };
 struct less_using_2nd_column { inline bool operator() (const string_table_t& struct1, const string_table_t& struct2) {  return (struct1.col2_ctime > struct2.col2_ctime); } };
 struct less_using_3rd_column { inline bool operator() (const string_table_t& struct1, const string_table_t& struct2) {  return (struct1.col3_dtime > struct2.col3_dtime); } };
@@ -120,12 +199,14 @@ typedef struct
     const char* version;
     int first_level;
     int last_level;
-    int additional_param;
+    size_t additional_param;   // param2, points to the key=value list of -e for the codecs with keys
     int max_block_size;
     compress_func compress;
     compress_func decompress;
     init_func init;
     deinit_func deinit;
+    const char* keys;          // the key=value parameters the codec accepts in -e, e.g. -ezstd_adv,19,wlog=23
+    uint32_t flags;            // LZBENCH_PLUGIN_* of plugin and built-in codecs
 } compressor_desc_t;
 
 
@@ -137,28 +218,32 @@ typedef struct
 
 
 
-#define LZBENCH_COMPRESSOR_COUNT 71
+#define LZBENCH_COMPRESSOR_COUNT 82
 
 static const compressor_desc_t comp_desc[LZBENCH_COMPRESSOR_COUNT] =
 {
     { "memcpy",     "",            0,   0,    0,       0, lzbench_return_0,            lzbench_memcpy,                NULL,                    NULL },
+    { "adaptive",   "1.0",         1,   3,    0,       0, lzbench_adaptive_compress,   lzbench_adaptive_decompress,   lzbench_adaptive_init,   lzbench_adaptive_deinit, NULL, LZBENCH_PLUGIN_NO_THREADS }, // --isa, --adaptive and --adaptive-link are global
     { "blosclz",    "2.0.0",       1,   9,    0, 64*1024, lzbench_blosclz_compress,    lzbench_blosclz_decompress,    NULL,                    NULL },
     { "brieflz",    "1.3.0",       1,   9,    0,       0, lzbench_brieflz_compress,    lzbench_brieflz_decompress,    lzbench_brieflz_init,    lzbench_brieflz_deinit },
     { "brotli",     "1.0.9",  0,  11,    0,       0, lzbench_brotli_compress,     lzbench_brotli_decompress,     NULL,                    NULL },
     { "brotli22",   "1.0.9",  0,  11,   22,       0, lzbench_brotli_compress,     lzbench_brotli_decompress,     NULL,                    NULL },
     { "brotli24",   "1.0.9",  0,  11,   24,       0, lzbench_brotli_compress,     lzbench_brotli_decompress,     NULL,                    NULL },
+    { "brotli_adv", "1.0.9",  0,  11,    0,       0, lzbench_brotli_adv_compress, lzbench_brotli_adv_decompress, lzbench_brotli_adv_init, lzbench_options_deinit, "mode,lgwin,lgblock,large_window" },
     { "bzip2",      "1.0.8",       1,   9,    0,       0, lzbench_bzip2_compress,      lzbench_bzip2_decompress,      NULL,                    NULL },
-    { "crush",      "1.0",         0,   2,    0,       0, lzbench_crush_compress,      lzbench_crush_decompress,      NULL,                    NULL },
-    { "csc",        "2016-10-13",  1,   5,    0,       0, lzbench_csc_compress,        lzbench_csc_decompress,        NULL,                    NULL },
+    { "crush",      "1.0",         0,   2,    0,       0, lzbench_crush_compress,      lzbench_crush_decompress,      NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
+    { "csc",        "2016-10-13",  1,   5,    0,       0, lzbench_csc_compress,        lzbench_csc_decompress,        NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
     { "density",    "0.14.2",      1,   3,    0,       0, lzbench_density_compress,    lzbench_density_decompress,    lzbench_density_init,    lzbench_density_deinit },
     { "fastlz",     "0.5.0",       1,   2,    0,       0, lzbench_fastlz_compress,     lzbench_fastlz_decompress,     NULL,                    NULL },
     { "fastlzma2",   "1.0.1",      1,  10,    0,       0, lzbench_fastlzma2_compress,  lzbench_fastlzma2_decompress,  NULL,                    NULL },
     { "gipfeli",    "2016-07-13",  0,   0,    0,       0, lzbench_gipfeli_compress,    lzbench_gipfeli_decompress,    NULL,                    NULL },
-    { "glza",       "0.8",         0,   0,    0,       0, lzbench_glza_compress,       lzbench_glza_decompress,       NULL,                    NULL },
+    { "glza",       "0.8",         0,   0,    0,       0, lzbench_glza_compress,       lzbench_glza_decompress,       NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
     { "libdeflate", "1.6",         1,  12,    0,       0, lzbench_libdeflate_compress, lzbench_libdeflate_decompress, NULL,                    NULL },
-    { "lz4",        "1.9.3",       0,   0,    0,       0, lzbench_lz4_compress,        lzbench_lz4_decompress,        NULL,                    NULL },
-    { "lz4fast",    "1.9.3",       1,  99,    0,       0, lzbench_lz4fast_compress,    lzbench_lz4_decompress,        NULL,                    NULL },
-    { "lz4hc",      "1.9.3",       1,  12,    0,       0, lzbench_lz4hc_compress,      lzbench_lz4_decompress,        NULL,                    NULL },
+    { "libdeflate_gzip", "1.6",    1,  12,    0,       0, lzbench_libdeflate_gzip_compress, lzbench_libdeflate_gzip_decompress, NULL,           NULL },
+    { "lz4",        "1.9.3",       0,   0,    0,       0, lzbench_lz4_compress,        lzbench_lz4_decompress,        NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lz4fast",    "1.9.3",       1,  99,    0,       0, lzbench_lz4fast_compress,    lzbench_lz4_decompress,        NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lz4hc",      "1.9.3",       1,  12,    0,       0, lzbench_lz4hc_compress,      lzbench_lz4_decompress,        NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lz4frame",   "1.9.3",       0,  12,    0,       0, lzbench_lz4frame_compress,   lzbench_lz4frame_decompress,   lzbench_lz4frame_init,   lzbench_lz4frame_deinit },
     { "lizard",     "1.0",  LIZARD_MIN_CLEVEL, LIZARD_MAX_CLEVEL, 0, 0, lzbench_lizard_compress,      lzbench_lizard_decompress,        NULL,                    NULL },
     { "lzf",        "3.6",         0,   1,    0,       0, lzbench_lzf_compress,        lzbench_lzf_decompress,        NULL,                    NULL },
     { "lzfse",      "2017-03-08",  0,   0,    0,       0, lzbench_lzfse_compress,      lzbench_lzfse_decompress,      lzbench_lzfse_init,      lzbench_lzfse_deinit },
@@ -169,6 +254,7 @@ static const compressor_desc_t comp_desc[LZBENCH_COMPRESSOR_COUNT] =
     { "lzjb",       "2010",        0,   0,    0,       0, lzbench_lzjb_compress,       lzbench_lzjb_decompress,       NULL,                    NULL },
     { "lzlib",      "1.12-rc2",    0,   9,    0,       0, lzbench_lzlib_compress,      lzbench_lzlib_decompress,      NULL,                    NULL },
     { "lzma",       "19.00",       0,   9,    0,       0, lzbench_lzma_compress,       lzbench_lzma_decompress,       NULL,                    NULL },
+    { "lzma_adv",   "19.00",       0,   9,    0,       0, lzbench_lzma_adv_compress,   lzbench_lzma_decompress,       lzbench_lzma_adv_init,   lzbench_options_deinit, "lc,lp,pb,dict,fb,mc,bt,hb" },
     { "lzmat",      "1.01",        0,   0,    0,       0, lzbench_lzmat_compress,      lzbench_lzmat_decompress,      NULL,                    NULL }, // decompression error (returns 0) and SEGFAULT (?)
     { "lzo1",       "2.10",        1,   1,    0,       0, lzbench_lzo1_compress,       lzbench_lzo1_decompress,       lzbench_lzo_init,        lzbench_lzo_deinit },
     { "lzo1a",      "2.10",        1,   1,    0,       0, lzbench_lzo1a_compress,      lzbench_lzo1a_decompress,      lzbench_lzo_init,        lzbench_lzo_deinit },
@@ -180,11 +266,13 @@ static const compressor_desc_t comp_desc[LZBENCH_COMPRESSOR_COUNT] =
     { "lzo1z",      "2.10",      999, 999,    0,       0, lzbench_lzo1z_compress,      lzbench_lzo1z_decompress,      lzbench_lzo_init,        lzbench_lzo_deinit },
     { "lzo2a",      "2.10",      999, 999,    0,       0, lzbench_lzo2a_compress,      lzbench_lzo2a_decompress,      lzbench_lzo_init,        lzbench_lzo_deinit },
     { "lzrw",       "15-Jul-1991", 1,   5,    0,       0, lzbench_lzrw_compress,       lzbench_lzrw_decompress,       lzbench_lzrw_init,       lzbench_lzrw_deinit },
-    { "lzsse2",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse2_compress,     lzbench_lzsse2_decompress,     lzbench_lzsse2_init,     lzbench_lzsse2_deinit },
-    { "lzsse4",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse4_compress,     lzbench_lzsse4_decompress,     lzbench_lzsse4_init,     lzbench_lzsse4_deinit },
-    { "lzsse4fast", "2019-04-18",  0,   0,    0,       0, lzbench_lzsse4fast_compress, lzbench_lzsse4_decompress,     lzbench_lzsse4fast_init, lzbench_lzsse4fast_deinit },
-    { "lzsse8",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse8_compress,     lzbench_lzsse8_decompress,     lzbench_lzsse8_init,     lzbench_lzsse8_deinit },
-    { "lzsse8fast", "2019-04-18",  0,   0,    0,       0, lzbench_lzsse8fast_compress, lzbench_lzsse8_decompress,     lzbench_lzsse8fast_init, lzbench_lzsse8fast_deinit },
+    { "lzsse2",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse2_compress,     lzbench_lzsse2_decompress,     lzbench_lzsse2_init,     lzbench_lzsse2_deinit,   NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse4",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse4_compress,     lzbench_lzsse4_decompress,     lzbench_lzsse4_init,     lzbench_lzsse4_deinit,   NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse4fast", "2019-04-18",  0,   0,    0,       0, lzbench_lzsse4fast_compress, lzbench_lzsse4_decompress,     lzbench_lzsse4fast_init, lzbench_lzsse4fast_deinit,NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse4_avx2","2019-04-18",  0,  17,    0,       0, lzbench_lzsse4_compress,     lzbench_lzsse4_avx2_decompress,lzbench_lzsse4_init,     lzbench_lzsse4_deinit,   NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse8",     "2019-04-18",  0,  17,    0,       0, lzbench_lzsse8_compress,     lzbench_lzsse8_decompress,     lzbench_lzsse8_init,     lzbench_lzsse8_deinit,   NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse8fast", "2019-04-18",  0,   0,    0,       0, lzbench_lzsse8fast_compress, lzbench_lzsse8_decompress,     lzbench_lzsse8fast_init, lzbench_lzsse8fast_deinit,NULL, LZBENCH_PLUGIN_INPLACE },
+    { "lzsse8_avx2","2019-04-18",  0,  17,    0,       0, lzbench_lzsse8_compress,     lzbench_lzsse8_avx2_decompress,lzbench_lzsse8_init,     lzbench_lzsse8_deinit,   NULL, LZBENCH_PLUGIN_INPLACE },
     { "lzvn",       "2017-03-08",  0,   0,    0,       0, lzbench_lzvn_compress,       lzbench_lzvn_decompress,       lzbench_lzvn_init,       lzbench_lzvn_deinit },
     { "pithy",      "2011-12-24",  0,   9,    0,       0, lzbench_pithy_compress,      lzbench_pithy_decompress,      NULL,                    NULL }, // decompression error (returns 0)
     { "quicklz",    "1.5.0",       1,   3,    0,       0, lzbench_quicklz_compress,    lzbench_quicklz_decompress,    NULL,                    NULL },
@@ -193,24 +281,28 @@ static const compressor_desc_t comp_desc[LZBENCH_COMPRESSOR_COUNT] =
     { "slz_gzip",   "1.2.0",       1,   3,    1,       0, lzbench_slz_compress,        lzbench_slz_decompress,        NULL,                    NULL },
     { "slz_zlib",   "1.2.0",       1,   3,    0,       0, lzbench_slz_compress,        lzbench_slz_decompress,        NULL,                    NULL },
     { "snappy",     "2020-07-11",  0,   0,    0,       0, lzbench_snappy_compress,     lzbench_snappy_decompress,     NULL,                    NULL },
-    { "tornado",    "0.6a",        1,  16,    0,       0, lzbench_tornado_compress,    lzbench_tornado_decompress,    NULL,                    NULL },
+    { "tornado",    "0.6a",        1,  16,    0,       0, lzbench_tornado_compress,    lzbench_tornado_decompress,    NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
     { "ucl_nrv2b",  "1.03",        1,   9,    0,       0, lzbench_ucl_nrv2b_compress,  lzbench_ucl_nrv2b_decompress,  NULL,                    NULL },
     { "ucl_nrv2d",  "1.03",        1,   9,    0,       0, lzbench_ucl_nrv2d_compress,  lzbench_ucl_nrv2d_decompress,  NULL,                    NULL },
     { "ucl_nrv2e",  "1.03",        1,   9,    0,       0, lzbench_ucl_nrv2e_compress,  lzbench_ucl_nrv2e_decompress,  NULL,                    NULL },
     { "wflz",       "2015-09-16",  0,   0,    0,       0, lzbench_wflz_compress,       lzbench_wflz_decompress,       lzbench_wflz_init,       lzbench_wflz_deinit }, // SEGFAULT on decompressiom with gcc 4.9+ -O3 on Ubuntu
     { "xpack",      "2016-06-02",  1,   9,    0,   1<<19, lzbench_xpack_compress,      lzbench_xpack_decompress,      lzbench_xpack_init,      lzbench_xpack_deinit },
     { "xz",         "5.2.5",       0,   9,    0,       0, lzbench_xz_compress,         lzbench_xz_decompress,         NULL,                    NULL },
+    { "xz_adv",     "5.2.5",       0,   9,    0,       0, lzbench_xz_adv_compress,     lzbench_xz_decompress,         lzbench_xz_adv_init,     lzbench_options_deinit, "dict,lc,lp,pb,mode,nice,mf,depth" },
     { "yalz77",     "2015-09-19",  1,  12,    0,       0, lzbench_yalz77_compress,     lzbench_yalz77_decompress,     NULL,                    NULL },
-    { "yappy",      "2014-03-22",  0,  99,    0,       0, lzbench_yappy_compress,      lzbench_yappy_decompress,      lzbench_yappy_init,      NULL },
+    { "yappy",      "2014-03-22",  0,  99,    0,       0, lzbench_yappy_compress,      lzbench_yappy_decompress,      lzbench_yappy_init,      NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
     { "zlib",       "1.2.11",      1,   9,    0,       0, lzbench_zlib_compress,       lzbench_zlib_decompress,       NULL,                    NULL },
+    { "zlib_simd",  "1.2.11",      1,   9,    0,       0, lzbench_zlib_simd_compress,  lzbench_zlib_simd_decompress,  NULL,                    NULL,                    NULL, LZBENCH_PLUGIN_NO_THREADS },
     { "zling",      "2018-10-12",  0,   4,    0,       0, lzbench_zling_compress,      lzbench_zling_decompress,      NULL,                    NULL },
-    { "zstd",       "1.4.8",       1,  22,    0,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit },
-    { "zstd_fast",  "1.4.8",       -5, -1,    0,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit },
-    { "zstd22",     "1.4.8",       1,  22,   22,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit },
-    { "zstd24",     "1.4.8",       1,  22,   24,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit },
-    { "zstdLDM",    "1.4.8",       1,  22,    0,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit },
-    { "zstd22LDM",  "1.4.8",       1,  22,   22,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit },
-    { "zstd24LDM",  "1.4.8",       1,  22,   24,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit },
+    { "zstd",       "1.4.8",       1,  22,    0,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd_fast",  "1.4.8",       -5, -1,    0,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd_chk",   "1.4.8",       1,  22,    0,       0, lzbench_zstd_chk_compress,   lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd22",     "1.4.8",       1,  22,   22,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd24",     "1.4.8",       1,  22,   24,       0, lzbench_zstd_compress,       lzbench_zstd_decompress,       lzbench_zstd_init,       lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstdLDM",    "1.4.8",       1,  22,    0,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd22LDM",  "1.4.8",       1,  22,   22,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd24LDM",  "1.4.8",       1,  22,   24,       0, lzbench_zstd_LDM_compress,   lzbench_zstd_decompress,       lzbench_zstd_LDM_init,   lzbench_zstd_deinit,     NULL, LZBENCH_PLUGIN_INPLACE },
+    { "zstd_adv",   "1.4.8",       1,  22,    0,       0, lzbench_zstd_adv_compress,   lzbench_zstd_decompress,       lzbench_zstd_adv_init,   lzbench_zstd_deinit, "wlog,clog,hlog,slog,mml,tlen,strat,ldm,chk" },
     { "nakamichi",  "okamigan",    0,   0,    0,       0, lzbench_nakamichi_compress,  lzbench_nakamichi_decompress,  NULL,                    NULL },
 };
 
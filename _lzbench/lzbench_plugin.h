@@ -0,0 +1,89 @@
+#ifndef LZBENCH_PLUGIN_H
+#define LZBENCH_PLUGIN_H
+
+/*
+ * ABI of the codec plugins loaded with --plugin=./libcodec.so. A plugin is a shared library built
+ * against this header alone that exports lzbench_plugin(). Its codecs mirror compressor_desc_t and
+ * are copied into the compressor list as they are, so lzbench calls their functions directly, like
+ * the built-in codecs. The strings and tables must stay valid while the library is loaded.
+ *
+ *   static const lzbench_plugin_codec_t codecs[] = {
+ *       { "mycodec", "1.0", 1, 9, 0, 0, my_compress, my_decompress, NULL, NULL, NULL, 0 } };
+ *   static const lzbench_plugin_alias_t aliases[] = { { "fast", "mycodec,1" } };
+ *   static const lzbench_plugin_t plugin = { LZBENCH_PLUGIN_VERSION, 1, codecs, 1, aliases };
+ *
+ *   LZBENCH_PLUGIN_EXPORT const lzbench_plugin_t* lzbench_plugin(uint32_t version)
+ *   {
+ *       return (version == LZBENCH_PLUGIN_VERSION) ? &plugin : NULL;
+ *   }
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LZBENCH_PLUGIN_VERSION 2           // changes with every incompatible change of the structs or flags below
+#define LZBENCH_PLUGIN_ENTRY "lzbench_plugin"
+
+/* capability flags of lzbench_plugin_codec_t */
+#define LZBENCH_PLUGIN_INPLACE        1    // the decoder accepts its input at the tail of its output, --inplace tests only these
+#define LZBENCH_PLUGIN_NO_ADVERSARIAL 2    // the decoder expects valid streams, --adversarial skips it
+#define LZBENCH_PLUGIN_NO_THREADS     4    // the codec keeps global state, concurrent liblzbench calls take turns
+
+#ifdef _WIN32
+    #define LZBENCH_PLUGIN_EXPORT_ __declspec(dllexport)
+#else
+    #define LZBENCH_PLUGIN_EXPORT_ __attribute__((visibility("default")))
+#endif
+#ifdef __cplusplus
+    #define LZBENCH_PLUGIN_EXPORT extern "C" LZBENCH_PLUGIN_EXPORT_
+extern "C" {
+#else
+    #define LZBENCH_PLUGIN_EXPORT LZBENCH_PLUGIN_EXPORT_
+#endif
+
+/* the same functions as the built-in codecs: compress and decompress return the output size or <= 0 on error,
+   param1 is the level, param2 is additional_param or the key=value list of -e, workmem is what init returned */
+typedef int64_t (*lzbench_plugin_compress_t)(char* in, size_t insize, char* out, size_t outsize, size_t param1, size_t param2, char* workmem);
+typedef char* (*lzbench_plugin_init_t)(size_t insize, size_t param1, size_t param2);
+typedef void (*lzbench_plugin_deinit_t)(char* workmem);
+
+typedef struct
+{
+    const char* name;
+    const char* version;
+    int first_level;
+    int last_level;
+    size_t additional_param;
+    int max_block_size;             // 0 if any chunk size works
+    lzbench_plugin_compress_t compress;
+    lzbench_plugin_compress_t decompress;
+    lzbench_plugin_init_t init;     // may be NULL, a NULL result rejects the key=value list if keys is set
+    lzbench_plugin_deinit_t deinit; // may be NULL
+    const char* keys;               // comma-separated keys accepted in -e, or NULL
+    uint32_t flags;                 // LZBENCH_PLUGIN_*
+} lzbench_plugin_codec_t;
+
+/* an alias of -e, an alias with a built-in name (e.g. "all") adds its list to the built-in one */
+typedef struct
+{
+    const char* name;
+    const char* params;
+} lzbench_plugin_alias_t;
+
+typedef struct
+{
+    uint32_t version;               // LZBENCH_PLUGIN_VERSION
+    uint32_t codec_count;
+    const lzbench_plugin_codec_t* codecs;
+    uint32_t alias_count;
+    const lzbench_plugin_alias_t* aliases;
+} lzbench_plugin_t;
+
+/* the exported entry point gets the LZBENCH_PLUGIN_VERSION of lzbench and returns NULL if it doesn't support it */
+typedef const lzbench_plugin_t* (*lzbench_plugin_func)(uint32_t version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
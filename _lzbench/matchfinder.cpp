@@ -0,0 +1,197 @@
+// match finders for the --mf option and the parse statistics of --parse-stats
+
+#include "matchfinder.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifndef BENCH_REMOVE_LZMA
+#include "lzma/LzFind.h"
+#endif
+
+#ifndef BENCH_REMOVE_LZ4
+#include "lz4/lz4.h"
+#include "lz4/lz4hc.h"
+#endif
+
+#ifndef BENCH_REMOVE_ZSTD
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd/lib/zstd.h"
+#endif
+
+extern "C"
+{
+    // mf_libdeflate.c
+    int mf_libdeflate_hc(const uint8_t* in, size_t insize, mf_stats_t* stats);
+    int mf_libdeflate_bt(const uint8_t* in, size_t insize, mf_stats_t* stats);
+}
+
+
+#ifndef BENCH_REMOVE_LZMA
+/* an ISzAlloc that counts the bytes of the match finder of one run */
+typedef struct
+{
+    ISzAlloc vt;
+    size_t allocated;
+} lzfind_alloc_t;
+
+static void* lzfind_alloc(ISzAllocPtr p, size_t size) { ((lzfind_alloc_t*)p)->allocated += size; return malloc(size); }
+static void lzfind_free(ISzAllocPtr, void* address) { free(address); }
+
+/* LzFind.c set up as LzmaEnc does for the direct input of LzmaEnc_MemEncode(), with its default fb and mc */
+static int lzfind_run(const uint8_t* in, size_t insize, mf_stats_t* stats, int btMode, int numHashBytes)
+{
+    const UInt32 fastBytes = 32, matchLenMax = 273;   // LZMA_MATCH_LEN_MAX of LzmaEnc.c
+    UInt32 distances[matchLenMax * 2 + 3];
+    UInt32 dictSize = (insize > (1 << 24)) ? (1 << 24) : (insize < (1 << 12)) ? (1 << 12) : (UInt32)insize;
+    CMatchFinder mf;
+    IMatchFinder vt;
+    lzfind_alloc_t alloc = { { lzfind_alloc, lzfind_free }, 0 };
+
+    MatchFinder_Construct(&mf);
+    mf.btMode = btMode;
+    mf.numHashBytes = numHashBytes;
+    mf.cutValue = (16 + (fastBytes >> 1)) >> (btMode ? 0 : 1);
+    mf.expectedDataSize = insize;
+    mf.directInput = 1;
+    mf.bufferBase = (Byte*)in;
+    mf.directInputRem = insize;
+
+    if (!MatchFinder_Create(&mf, dictSize, 0, fastBytes, matchLenMax, &alloc.vt))
+        return MF_NO_MEMORY;
+    stats->memory = alloc.allocated;
+    MatchFinder_CreateVTable(&mf, &vt);
+    vt.Init(&mf);
+    while (vt.GetNumAvailableBytes(&mf))
+    {
+        UInt32 n = vt.GetMatches(&mf, distances);
+        stats->positions++;
+        if (n)
+        {
+            stats->matches++;
+            stats->len_sum += distances[n - 2];   // the pairs are sorted by length
+        }
+    }
+    MatchFinder_Free(&mf, &alloc.vt);
+    return MF_OK;
+}
+
+static int lzma_hc4(const uint8_t* in, size_t insize, mf_stats_t* stats) { return lzfind_run(in, insize, stats, 0, 4); }
+static int lzma_bt2(const uint8_t* in, size_t insize, mf_stats_t* stats) { return lzfind_run(in, insize, stats, 1, 2); }
+static int lzma_bt3(const uint8_t* in, size_t insize, mf_stats_t* stats) { return lzfind_run(in, insize, stats, 1, 3); }
+static int lzma_bt4(const uint8_t* in, size_t insize, mf_stats_t* stats) { return lzfind_run(in, insize, stats, 1, 4); }
+#endif
+
+
+const mf_desc_t mf_desc[] =
+{
+#ifndef BENCH_REMOVE_LZMA
+    { "lzma_hc4",       "lzma 19.00",       "fb=32 mc=16",      lzma_hc4 },
+    { "lzma_bt2",       "lzma 19.00",       "fb=32 mc=32",      lzma_bt2 },
+    { "lzma_bt3",       "lzma 19.00",       "fb=32 mc=32",      lzma_bt3 },
+    { "lzma_bt4",       "lzma 19.00",       "fb=32 mc=32",      lzma_bt4 },
+#endif
+#ifndef BENCH_REMOVE_LIBDEFLATE
+    { "libdeflate_hc",  "libdeflate 1.6",   "depth=40 nice=65", mf_libdeflate_hc },
+    { "libdeflate_bt",  "libdeflate 1.6",   "depth=30 nice=50", mf_libdeflate_bt },
+#endif
+};
+
+const int mf_desc_count = sizeof(mf_desc) / sizeof(mf_desc[0]);
+
+
+static int parse_bucket(uint64_t value)
+{
+    int n = 0;
+    while (value >>= 1) n++;
+    return (n < PARSE_BUCKETS) ? n : PARSE_BUCKETS - 1;
+}
+
+static void parse_add_match(parse_stats_t* stats, uint64_t len, uint64_t offset)
+{
+    stats->matches++;
+    stats->len_sum += len;
+    stats->offset_sum += offset;
+    stats->len_hist[parse_bucket(len)]++;
+    stats->offset_hist[parse_bucket(offset)]++;
+}
+
+#ifndef BENCH_REMOVE_LZ4
+/* reads the sequences of an LZ4 block, see lz4_Block_format.md */
+static size_t parse_lz4_block(const uint8_t* ip, size_t size, parse_stats_t* stats)
+{
+    const uint8_t *iend = ip + size;
+    size_t matched = 0;
+
+    while (ip < iend)
+    {
+        size_t len = *ip >> 4;
+        size_t mlen = *ip++ & 15;
+        if (len == 15) { uint8_t b; do { b = *ip++; len += b; } while (b == 255); }
+        ip += len;
+        if (ip >= iend) break;   // the last sequence has only literals
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (mlen == 15) { uint8_t b; do { b = *ip++; mlen += b; } while (b == 255); }
+        parse_add_match(stats, mlen + 4, offset);
+        matched += mlen + 4;
+    }
+    return matched;
+}
+#endif
+
+#ifndef BENCH_REMOVE_ZSTD
+/* the sequences collected by ZSTD_generateSequences() with the parameters of lzbench_zstd_compress() and lzbench_zstd_LDM_compress() */
+static size_t parse_zstd(const uint8_t* in, size_t insize, int level, size_t windowLog, int ldm, parse_stats_t* stats)
+{
+    std::vector<ZSTD_Sequence> seqs(insize / 3 + insize / ZSTD_BLOCKSIZE_MAX + 2);
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    size_t matched = 0;
+
+    if (!cctx) return 0;
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+    if (windowLog) ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, (int)windowLog);
+    if (ldm) ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
+    size_t count = ZSTD_generateSequences(cctx, &seqs[0], seqs.size(), in, insize);
+    ZSTD_freeCCtx(cctx);
+    if (ZSTD_isError(count)) return 0;
+
+    for (size_t i=0; i<count; i++)
+    {
+        if (!seqs[i].matchLength) continue;   // block delimiter with the last literals
+        parse_add_match(stats, seqs[i].matchLength, seqs[i].offset);
+        if (seqs[i].rep) stats->rep_matches++;
+        matched += seqs[i].matchLength;
+    }
+    return matched;
+}
+#endif
+
+
+int parse_stats_add(int parse, int level, size_t param2, const uint8_t* in, size_t insize, uint8_t* tmp, size_t tmpsize, parse_stats_t* stats)
+{
+    size_t matched;
+
+#ifndef BENCH_REMOVE_LZ4
+    if (parse == PARSE_LZ4 || parse == PARSE_LZ4FAST || parse == PARSE_LZ4HC)
+    {
+        int clen;
+        if (parse == PARSE_LZ4HC)
+            clen = LZ4_compress_HC((const char*)in, (char*)tmp, insize, tmpsize, level);
+        else
+            clen = LZ4_compress_fast((const char*)in, (char*)tmp, insize, tmpsize, (parse == PARSE_LZ4FAST) ? level : 1);
+        matched = (clen > 0) ? parse_lz4_block(tmp, clen, stats) : 0;
+        stats->literals += insize - matched;
+        return 1;
+    }
+#endif
+#ifndef BENCH_REMOVE_ZSTD
+    if (parse == PARSE_ZSTD || parse == PARSE_ZSTD_LDM)
+    {
+        matched = parse_zstd(in, insize, level, param2, parse == PARSE_ZSTD_LDM, stats);
+        stats->literals += insize - matched;   // also the blocks zstd stores without sequences
+        return 1;
+    }
+#endif
+    return 0;
+}
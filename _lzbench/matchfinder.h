@@ -0,0 +1,59 @@
+#ifndef LZBENCH_MATCHFINDER_H
+#define LZBENCH_MATCHFINDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Match finders of the compressors run alone for the --mf option. A run searches every position of
+ * one chunk for its longest match, as an optimal parser would, and counts the positions with a match
+ * of at least min_len bytes and the bytes allocated by the match finder.
+ */
+typedef struct
+{
+    uint64_t positions;
+    uint64_t matches;
+    uint64_t len_sum;       // of the longest match at each matched position
+    size_t memory;
+} mf_stats_t;
+
+enum { MF_OK=0, MF_NO_MEMORY, MF_NO_INPUT };  // results of a run and of mf_test()
+
+typedef int (*mf_func)(const uint8_t* in, size_t insize, mf_stats_t* stats);   // returns MF_OK or MF_NO_MEMORY
+
+typedef struct
+{
+    const char* name;
+    const char* version;
+    const char* params;
+    mf_func run;
+} mf_desc_t;
+
+extern const mf_desc_t mf_desc[];
+extern const int mf_desc_count;
+
+
+/*
+ * Parse of a codec for the --parse-stats option, read back from the sequences of its output. Lengths
+ * and offsets are counted in log2 buckets, bucket n holds the values in [2^n, 2^(n+1)).
+ */
+#define PARSE_BUCKETS 32
+
+typedef struct
+{
+    uint64_t literals;
+    uint64_t matches;
+    uint64_t rep_matches;   // matches with a repeat offset, if the format has them
+    uint64_t len_sum;
+    uint64_t offset_sum;
+    uint64_t len_hist[PARSE_BUCKETS];
+    uint64_t offset_hist[PARSE_BUCKETS];
+} parse_stats_t;
+
+/* the parses of the lz4 and zstd compress functions that parse_stats_add() reproduces */
+enum { PARSE_LZ4 = 1, PARSE_LZ4FAST, PARSE_LZ4HC, PARSE_ZSTD, PARSE_ZSTD_LDM };
+
+/* adds the parse of one chunk to stats (tmp holds the compressed chunk), returns 0 for parses not built in */
+int parse_stats_add(int parse, int level, size_t param2, const uint8_t* in, size_t insize, uint8_t* tmp, size_t tmpsize, parse_stats_t* stats);
+
+#endif
@@ -0,0 +1,76 @@
+// libdeflate match finders for the --mf option, in C because the libdeflate headers are C-only
+
+#ifndef BENCH_REMOVE_LIBDEFLATE
+#define MATCHFINDER_WINDOW_ORDER 15
+#include "libdeflate/hc_matchfinder.h"
+#include "libdeflate/bt_matchfinder.h"
+#include "libdeflate/deflate_constants.h"
+#include "matchfinder.h"
+
+
+/* hash chains with the search depth and nice length of libdeflate level 6 */
+int mf_libdeflate_hc(const uint8_t* in, size_t insize, mf_stats_t* stats)
+{
+	struct hc_matchfinder *mf = libdeflate_aligned_malloc(MATCHFINDER_ALIGNMENT, sizeof(*mf));
+	const u8 *in_base = in, *in_next = in, *in_end = in + insize;
+	u32 next_hashes[2] = {0, 0};
+
+	if (!mf) return MF_NO_MEMORY;
+	stats->memory = sizeof(*mf);
+	hc_matchfinder_init(mf);
+	for (; in_next < in_end; in_next++) {
+		u32 max_len = MIN(in_end - in_next, DEFLATE_MAX_MATCH_LEN);
+		u32 offset, len;
+
+		len = hc_matchfinder_longest_match(mf, &in_base, in_next, DEFLATE_MIN_MATCH_LEN - 1, max_len,
+						   MIN(65, max_len), 40, next_hashes, &offset);
+		stats->positions++;
+		if (len >= DEFLATE_MIN_MATCH_LEN) {
+			stats->matches++;
+			stats->len_sum += len;
+		}
+	}
+	libdeflate_aligned_free(mf);
+	return MF_OK;
+}
+
+/* binary trees with the search depth and nice length of libdeflate level 10, the window is slid as in deflate_compress_near_optimal() */
+int mf_libdeflate_bt(const uint8_t* in, size_t insize, mf_stats_t* stats)
+{
+	struct bt_matchfinder *mf = libdeflate_aligned_malloc(MATCHFINDER_ALIGNMENT, sizeof(*mf));
+	struct lz_match matches[DEFLATE_MAX_MATCH_LEN + 1];
+	const u8 *in_cur_base = in, *in_next = in, *in_end = in + insize;
+	const u8 *in_next_slide = in + MIN(insize, MATCHFINDER_WINDOW_SIZE);
+	u32 max_len = DEFLATE_MAX_MATCH_LEN, nice_len = 50;
+	u32 next_hashes[2] = {0, 0};
+
+	if (!mf) return MF_NO_MEMORY;
+	stats->memory = sizeof(*mf);
+	bt_matchfinder_init(mf);
+	for (; in_next < in_end; in_next++) {
+		struct lz_match *end = matches;
+		u32 best_len;
+
+		if (in_next == in_next_slide) {
+			bt_matchfinder_slide_window(mf);
+			in_cur_base = in_next;
+			in_next_slide = in_next + MIN(in_end - in_next, MATCHFINDER_WINDOW_SIZE);
+		}
+		if (max_len > in_end - in_next) {
+			max_len = in_end - in_next;
+			nice_len = MIN(nice_len, max_len);
+		}
+		if (max_len >= BT_MATCHFINDER_REQUIRED_NBYTES)
+			end = bt_matchfinder_get_matches(mf, in_cur_base, in_next - in_cur_base, max_len, nice_len,
+							 30, next_hashes, &best_len, matches);
+		stats->positions++;
+		if (end != matches) {	/* sorted by length, best_len is 3 also without a match */
+			stats->matches++;
+			stats->len_sum += end[-1].length;
+		}
+	}
+	libdeflate_aligned_free(mf);
+	return MF_OK;
+}
+
+#endif
@@ -0,0 +1,42 @@
+// loading of the codec plugins of the --plugin option
+
+#include "plugin.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <dlfcn.h>
+#endif
+
+
+const lzbench_plugin_t* plugin_load(const char* path)
+{
+    lzbench_plugin_func entry;
+    const lzbench_plugin_t* plugin;
+
+#ifdef _WIN32
+    HMODULE lib = LoadLibraryA(path);
+    if (!lib) { fprintf(stderr, "%s: cannot load (error %lu)\n", path, (unsigned long)GetLastError()); return NULL; }
+    entry = (lzbench_plugin_func)GetProcAddress(lib, LZBENCH_PLUGIN_ENTRY);
+    if (!entry) { fprintf(stderr, "%s: no %s() function\n", path, LZBENCH_PLUGIN_ENTRY); FreeLibrary(lib); return NULL; }
+#else
+    void* lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!lib) { fprintf(stderr, "%s\n", dlerror()); return NULL; }
+    entry = (lzbench_plugin_func)dlsym(lib, LZBENCH_PLUGIN_ENTRY);
+    if (!entry) { fprintf(stderr, "%s: no %s() function\n", path, LZBENCH_PLUGIN_ENTRY); dlclose(lib); return NULL; }
+#endif
+
+    plugin = entry(LZBENCH_PLUGIN_VERSION);
+    if (!plugin || plugin->version != LZBENCH_PLUGIN_VERSION)
+    {
+        fprintf(stderr, "%s: plugin version %u, lzbench supports version %u\n", path, plugin ? plugin->version : 0, LZBENCH_PLUGIN_VERSION);
+#ifdef _WIN32
+        FreeLibrary(lib);
+#else
+        dlclose(lib);
+#endif
+        return NULL;
+    }
+    return plugin;
+}
@@ -0,0 +1,14 @@
+#ifndef LZBENCH_PLUGIN_LOADER_H
+#define LZBENCH_PLUGIN_LOADER_H
+
+#include "lzbench_plugin.h"
+
+/*
+ * Loading of the --plugin libraries. A library stays loaded until lzbench exits, as its codecs and
+ * aliases point into it.
+ */
+
+/* loads the library and checks its version, prints the reason and returns NULL on failure */
+const lzbench_plugin_t* plugin_load(const char* path);
+
+#endif
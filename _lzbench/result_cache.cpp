@@ -0,0 +1,175 @@
+// on-disk results of earlier runs for the --cache option
+
+#include "result_cache.h"
+#include "isa.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+#endif
+
+#if defined(__linux__)
+    #include <link.h>    // dl_iterate_phdr
+    #include <elf.h>     // NT_GNU_BUILD_ID
+#endif
+
+#ifndef LZBENCH_BUILD_ID
+    #define LZBENCH_BUILD_ID ""
+#endif
+
+
+/* the brand string of x86 CPUs, the model name of /proc/cpuinfo elsewhere */
+static std::string cpu_model()
+{
+    std::string model;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int regs[12];
+    if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004)
+    {
+        for (unsigned int i=0; i<3; i++)
+            __get_cpuid(0x80000002 + i, &regs[4*i], &regs[4*i+1], &regs[4*i+2], &regs[4*i+3]);
+        model.assign((const char*)regs, strnlen((const char*)regs, sizeof(regs)));
+    }
+#else
+    FILE* f = fopen("/proc/cpuinfo", "r");
+    char line[256];
+    while (f && model.empty() && fgets(line, sizeof(line), f))
+    {
+        const char* colon = strchr(line, ':');
+        if (colon && (!strncmp(line, "model name", 10) || !strncmp(line, "Model", 5) || !strncmp(line, "cpu model", 9)))
+            model.assign(colon + 1, strcspn(colon + 1, "\n"));
+    }
+    if (f) fclose(f);
+#endif
+    size_t first = model.find_first_not_of(' '), last = model.find_last_not_of(' ');
+    return (first == std::string::npos) ? "unknown" : model.substr(first, last - first + 1);
+}
+
+
+#if defined(__linux__)
+/* the hex of the NT_GNU_BUILD_ID note of the executable, the first object of dl_iterate_phdr() */
+static int build_id_note(struct dl_phdr_info* info, size_t, void* data)
+{
+    std::string* id = (std::string*)data;
+
+    for (int i=0; i<info->dlpi_phnum && id->empty(); i++)
+    {
+        if (info->dlpi_phdr[i].p_type != PT_NOTE) continue;
+        const char* p = (const char*)(info->dlpi_addr + info->dlpi_phdr[i].p_vaddr);
+        const char* end = p + info->dlpi_phdr[i].p_memsz;
+        while (p + sizeof(ElfW(Nhdr)) <= end)
+        {
+            const ElfW(Nhdr)* note = (const ElfW(Nhdr)*)p;
+            const char* name = p + sizeof(ElfW(Nhdr));
+            const unsigned char* desc = (const unsigned char*)name + ((note->n_namesz + 3) & ~3);
+            if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4 && !memcmp(name, "GNU", 4))
+            {
+                char hex[3];
+                for (unsigned j=0; j<note->n_descsz; j++) { snprintf(hex, sizeof(hex), "%02x", desc[j]); *id += hex; }
+                break;
+            }
+            p = (const char*)desc + ((note->n_descsz + 3) & ~3);
+        }
+    }
+    return 1;
+}
+#endif
+
+
+/* identifies the binary: its GNU build ID, else the FNV-1a hash of /proc/self/exe, empty where neither exists */
+static std::string binary_id()
+{
+    std::string id;
+#if defined(__linux__)
+    dl_iterate_phdr(build_id_note, &id);
+    if (!id.empty()) return id;
+
+    FILE* f = fopen("/proc/self/exe", "rb");
+    unsigned char buf[1 << 16];
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t n;
+    if (!f) return id;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+        for (size_t i=0; i<n; i++) hash = (hash ^ buf[i]) * 0x100000001b3ULL;
+    fclose(f);
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    id = hex;
+#endif
+    return id;
+}
+
+
+/* a whole line without the newline, false at the end of the file; rows with long encoders don't fit a fixed buffer */
+static bool read_line(FILE* f, std::string& line)
+{
+    int c;
+    line.clear();
+    while ((c = fgetc(f)) != EOF && c != '\n') line += (char)c;
+    return c != EOF || !line.empty();
+}
+
+
+bool cache_open(result_cache_t* cache, const char* path, int isa)
+{
+    std::string line;
+    FILE* f = fopen(path, "r");
+
+    while (f && read_line(f, line))
+    {
+        cache_entry_t e;
+        size_t values = line.rfind('\t');   // the key fields, then the values after the last tab
+        unsigned long long v[4];
+        if (values == std::string::npos || sscanf(line.c_str() + values + 1, "%llu %llu %llu %llu", &v[0], &v[1], &v[2], &v[3]) != 4) continue;
+        e.ctime = v[0]; e.dtime = v[1]; e.comprsize = v[2]; e.origsize = v[3];
+        cache->entries[line.substr(0, values)] = e;
+    }
+    if (f) fclose(f);
+
+    std::string id = binary_id();
+    cache->build = std::string(
+#if defined(__clang__)
+        "clang "
+#elif defined(__GNUC__)
+        "gcc "
+#endif
+        __VERSION__ " ") + isa_names[isa] + (id.empty() ? "" : " " + id) + (LZBENCH_BUILD_ID[0] ? " " LZBENCH_BUILD_ID : "") + "\t" + cpu_model();
+    cache->file = fopen(path, "a");
+    return cache->file != NULL;
+}
+
+
+void cache_close(result_cache_t* cache)
+{
+    if (cache->file) fclose(cache->file);
+    cache->file = NULL;
+}
+
+
+std::string cache_key(const result_cache_t* cache, uint64_t input_hash, size_t files, const char* name, const char* version, int level,
+                      const std::string& params, size_t chunk_size)
+{
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%016llx\t%llu\t%s\t%s\t%d\t", (unsigned long long)input_hash, (unsigned long long)files, name, version, level);
+    return buf + params + "\t" + std::to_string((unsigned long long)chunk_size) + "\t" + cache->timing + "\t" + cache->build;
+}
+
+
+bool cache_find(result_cache_t* cache, const std::string& key, cache_entry_t* entry)
+{
+    std::map<std::string, cache_entry_t>::const_iterator it = cache->entries.find(key);
+
+    if (cache->refresh || it == cache->entries.end()) { cache->misses++; return false; }
+    *entry = it->second;
+    cache->hits++;
+    return true;
+}
+
+
+void cache_store(result_cache_t* cache, const std::string& key, const cache_entry_t* entry)
+{
+    cache->entries[key] = *entry;
+    fprintf(cache->file, "%s\t%llu %llu %llu %llu\n", key.c_str(), (unsigned long long)entry->ctime, (unsigned long long)entry->dtime,
+        (unsigned long long)entry->comprsize, (unsigned long long)entry->origsize);
+    fflush(cache->file);  // rows measured before an interrupted sweep stay cached
+}
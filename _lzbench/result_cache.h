@@ -0,0 +1,43 @@
+#ifndef LZBENCH_RESULT_CACHE_H
+#define LZBENCH_RESULT_CACHE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <map>
+#include <string>
+
+/*
+ * On-disk results of earlier runs for the --cache option. A row is keyed by the XXH64 of the input,
+ * the number of files, the compressor name and version, level, parameters, chunk size, the timing
+ * settings (-p, -t, -u, -i), the build (compiler, ISA, the GNU build ID of the binary or a hash of it, and
+ * the BUILD_ID of make) and the CPU model, so a changed codec, binary, measurement or machine measures again
+ * and everything else is reused. The file is a tab-separated text file that is only appended to; a later
+ * line with the same key replaces an earlier one, e.g. after --refresh.
+ */
+#define RESULT_CACHE_DEFAULT_FILE "lzbench.cache"
+
+typedef struct
+{
+    uint64_t ctime, dtime, comprsize, origsize;
+} cache_entry_t;
+
+typedef struct
+{
+    std::map<std::string, cache_entry_t> entries;
+    FILE* file;           // opened for appending
+    std::string build;    // build and CPU fields of every key
+    std::string timing;   // -p, -t, -u and -i of every key, set after cache_open()
+    int refresh;          // --refresh measures every row again and stores it
+    uint32_t hits, misses;
+} result_cache_t;
+
+/* loads the entries of path and opens it for appending, returns false if it can't be written */
+bool cache_open(result_cache_t* cache, const char* path, int isa);
+void cache_close(result_cache_t* cache);
+
+std::string cache_key(const result_cache_t* cache, uint64_t input_hash, size_t files, const char* name, const char* version, int level,
+                      const std::string& params, size_t chunk_size);
+bool cache_find(result_cache_t* cache, const std::string& key, cache_entry_t* entry);
+void cache_store(result_cache_t* cache, const std::string& key, const cache_entry_t* entry);
+
+#endif
@@ -0,0 +1,137 @@
+// cache sizes and STREAM-style bandwidth kernels of the --roofline option
+
+#include "roofline.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__APPLE__) || defined(__MACH__)
+    #include <sys/sysctl.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <immintrin.h>
+    #define ROOFLINE_X86_KERNELS
+#endif
+
+const char* roofline_level_names[ROOF_LEVELS] = { "L1", "L2", "LLC", "DRAM" };
+const char* roofline_kernel_names[ROOF_KERNELS] = { "read", "write", "copy" };
+
+
+void roofline_cache_sizes(size_t caches[3])
+{
+    caches[0] = 32 << 10;
+    caches[1] = 1 << 20;
+    caches[2] = 8 << 20;
+#if defined(__APPLE__) || defined(__MACH__)
+    static const char* names[3] = { "hw.l1dcachesize", "hw.l2cachesize", "hw.l3cachesize" };
+    for (int i=0; i<3; i++)
+    {
+        uint64_t value = 0;
+        size_t len = sizeof(value);
+        if (sysctlbyname(names[i], &value, &len, NULL, 0) == 0 && value) caches[i] = value;
+    }
+    if (caches[2] < caches[1]) caches[2] = caches[1]; // no L3
+#elif !defined(_WIN32)
+    size_t found[4] = { 0, 0, 0, 0 };
+    for (int i=0; i<8; i++)
+    {
+        char path[96], type[32] = "";
+        unsigned level = 0, kb = 0;
+        FILE* f;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", i);
+        if (!(f = fopen(path, "r"))) break;
+        if (fscanf(f, "%u", &level) != 1) level = 0;
+        fclose(f);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", i);
+        if ((f = fopen(path, "r"))) { if (fscanf(f, "%31s", type) != 1) type[0] = 0; fclose(f); }
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", i);
+        if ((f = fopen(path, "r"))) { if (fscanf(f, "%uK", &kb) != 1) kb = 0; fclose(f); }
+        if (level >= 1 && level <= 3 && strcmp(type, "Instruction")) found[level] = (size_t)kb << 10;
+    }
+    if (found[1]) caches[0] = found[1];
+    if (found[2]) caches[1] = found[2];
+    if (found[3]) caches[2] = found[3];
+    else if (found[2]) caches[2] = found[2]; // no L3
+#endif
+}
+
+
+size_t roofline_level_size(const size_t caches[3], int level)
+{
+    if (level < ROOF_DRAM) return caches[level] / 2;
+    return (caches[2] * 4 > ROOFLINE_MIN_DRAM_SIZE) ? caches[2] * 4 : ROOFLINE_MIN_DRAM_SIZE;
+}
+
+
+int roofline_level(const size_t caches[3], size_t footprint)
+{
+    int level = ROOF_L1;
+    while (level < ROOF_DRAM && footprint > caches[level]) level++;
+    return level;
+}
+
+
+#ifdef ROOFLINE_X86_KERNELS
+// the read kernel with the widest loads the CPU has, like the memset and memcpy of glibc; 2 sums of 2 loads per 64 bytes
+__attribute__((target("avx512f")))
+static uint64_t roofline_read_avx512(const uint8_t* src, size_t size)
+{
+    __m512i s0 = _mm512_setzero_si512(), s1 = _mm512_setzero_si512();
+    for (size_t i=0; i<size; i+=128)
+    {
+        s0 = _mm512_add_epi64(s0, _mm512_loadu_si512((const void*)(src + i)));
+        s1 = _mm512_add_epi64(s1, _mm512_loadu_si512((const void*)(src + i + 64)));
+    }
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(s0, s1));
+}
+
+__attribute__((target("avx2")))
+static uint64_t roofline_read_avx2(const uint8_t* src, size_t size)
+{
+    __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+    for (size_t i=0; i<size; i+=64)
+    {
+        s0 = _mm256_add_epi64(s0, _mm256_loadu_si256((const __m256i*)(src + i)));
+        s1 = _mm256_add_epi64(s1, _mm256_loadu_si256((const __m256i*)(src + i + 32)));
+    }
+    s0 = _mm256_add_epi64(s0, s1);
+    return (uint64_t)_mm256_extract_epi64(s0, 0) + _mm256_extract_epi64(s0, 1) + _mm256_extract_epi64(s0, 2) + _mm256_extract_epi64(s0, 3);
+}
+#endif
+
+static uint64_t roofline_read(const uint8_t* src, size_t size)
+{
+#ifdef ROOFLINE_X86_KERNELS
+    static int width = __builtin_cpu_supports("avx512f") ? 64 : __builtin_cpu_supports("avx2") ? 32 : 8;
+    if (width == 64 && size % 128 == 0) return roofline_read_avx512(src, size);
+    if (width >= 32) return roofline_read_avx2(src, size);
+#endif
+    // 4 independent sums, so the loads are not serialized by the additions
+    const uint64_t* p = (const uint64_t*)src;
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t i=0; i<size/8; i+=4)
+    {
+        s0 += p[i];
+        s1 += p[i+1];
+        s2 += p[i+2];
+        s3 += p[i+3];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+
+uint64_t roofline_run(int kernel, uint8_t* dst, const uint8_t* src, size_t size)
+{
+    switch (kernel)
+    {
+    case ROOF_READ:
+        return roofline_read(src, size);
+    case ROOF_WRITE:
+        memset(dst, (int)size, size);
+        return dst[0];
+    default:
+        memcpy(dst, src, size);
+        return dst[size - 1];
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef LZBENCH_ROOFLINE_H
+#define LZBENCH_ROOFLINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Bandwidth kernels of the --roofline option. Like STREAM, each kernel streams over a buffer: read
+ * sums its 64-bit words, write fills it and copy is memcpy (counted as bytes copied, like the memcpy
+ * row). On x86 read uses AVX-512 or AVX2 loads when the CPU has them, as memset and memcpy do. Each level of the memory hierarchy is measured with buffers of half its size, DRAM with
+ * buffers of 4x the last level cache. A decoder whose input and output fit in a level is bounded by
+ * reading its input and writing its output at the bandwidths of that level.
+ */
+enum roofline_level_e { ROOF_L1=0, ROOF_L2, ROOF_LLC, ROOF_DRAM, ROOF_LEVELS };
+enum roofline_kernel_e { ROOF_READ=0, ROOF_WRITE, ROOF_COPY, ROOF_KERNELS };
+
+#define ROOFLINE_MIN_DRAM_SIZE (64*1024*1024)
+#define ROOFLINE_MEMORY_BOUND 0.5  // decoders at half of their bound or more are reported as memory-bound
+
+extern const char* roofline_level_names[ROOF_LEVELS];
+extern const char* roofline_kernel_names[ROOF_KERNELS];
+
+/* the data cache sizes of L1, L2 and the last level, from sysfs or sysctl, 32 KB / 1 MB / 8 MB if unknown */
+void roofline_cache_sizes(size_t caches[3]);
+
+/* the size of each buffer measured for the level */
+size_t roofline_level_size(const size_t caches[3], int level);
+
+/* the smallest level that holds footprint bytes */
+int roofline_level(const size_t caches[3], size_t footprint);
+
+/* one pass of the kernel over size bytes (a multiple of 64), the result keeps the reads from being optimized out */
+uint64_t roofline_run(int kernel, uint8_t* dst, const uint8_t* src, size_t size);
+
+#endif
@@ -0,0 +1,56 @@
+// stream counts and the memory of the contexts of the --streams option
+
+#include "streams.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__APPLE__) || defined(__MACH__)
+    #include <mach/mach.h>
+    #include <malloc/malloc.h>
+#elif !defined(_WIN32)
+    #include <unistd.h>
+    #include <malloc.h>
+#endif
+
+
+bool streams_parse(const char* list, std::vector<unsigned>& counts)
+{
+    const char* p = list;
+    char* end;
+
+    counts.clear();
+    while (*p)
+    {
+        unsigned long k = strtoul(p, &end, 10);
+        if (end == p || k == 0 || k > STREAMS_MAX || (*end && *end != ',')) return false;
+        counts.push_back((unsigned)k);
+        p = *end ? end + 1 : end;
+    }
+    return !counts.empty();
+}
+
+
+size_t streams_allocated_memory()
+{
+#if defined(__APPLE__) || defined(__MACH__)
+    malloc_statistics_t stats;
+    malloc_zone_statistics(NULL, &stats);  // all zones
+    if (stats.size_in_use) return stats.size_in_use;
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) return 0;
+    return info.resident_size;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;   // of all arenas
+#elif !defined(_WIN32)
+    unsigned long size, resident;
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%lu %lu", &size, &resident) != 2) resident = 0;
+    fclose(f);
+    return (size_t)resident * sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,25 @@
+#ifndef LZBENCH_STREAMS_H
+#define LZBENCH_STREAMS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/*
+ * The --streams option: K contexts of a codec (desc->init) on one thread, with the chunks of -b sent to
+ * them round-robin, as a proxy that multiplexes many live streams. With many contexts their tables
+ * are evicted from the caches between two calls of the same stream. The memory of the contexts is
+ * the growth of the heap bytes in use while they are created and used, which unlike the resident
+ * set doesn't miss memory that malloc reuses from earlier runs.
+ */
+#define STREAMS_DEFAULT_LIST "1,10,100,1000,10000"
+#define STREAMS_MAX 1000000
+
+/* the stream counts of a ','-separated list, false if one is 0 or over STREAMS_MAX */
+bool streams_parse(const char* list, std::vector<unsigned>& counts);
+
+/* bytes in use of the heap of the process (of malloc, with its mmap'ed blocks), the resident set if
+   the C library doesn't tell, 0 if unknown */
+size_t streams_allocated_memory();
+
+#endif
@@ -0,0 +1,187 @@
+// request sizes and arrival times of the --workload option
+
+#include "workload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+
+const char* workload_bucket_names[WORKLOAD_BUCKETS] = { "< 1 KB", "1-10 KB", "10-100 KB", "100 KB-1 MB", "1-10 MB", ">= 10 MB" };
+
+
+static inline uint64_t workload_rand(uint64_t* state)
+{
+    // splitmix64
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/* uniform in (0, 1) */
+static inline double workload_uniform(uint64_t* state)
+{
+    return ((workload_rand(state) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static bool workload_size(const char* str, uint64_t* size)
+{
+    char* end;
+    double v = strtod(str, &end);
+    if (end == str || v < 0) return false;
+    switch (*end)
+    {
+        case 'K': case 'k': v *= 1 << 10; end++; break;
+        case 'M': case 'm': v *= 1 << 20; end++; break;
+        case 'G': case 'g': v *= 1 << 30; end++; break;
+    }
+    *size = (uint64_t)v;
+    return *end == 0;
+}
+
+/* a decimal number in [0, max] */
+static bool workload_number(const char* str, double max, double* value)
+{
+    char* end;
+    double v = strtod(str, &end);
+    if (end == str || *end || !(v >= 0 && v <= max)) return false;
+    *value = v;
+    return true;
+}
+
+/* a decimal integer in [0, max] */
+static bool workload_integer(const char* str, uint64_t max, uint64_t* value)
+{
+    char* end;
+    unsigned long long v;
+    if (*str < '0' || *str > '9') return false;  // strtoull takes "-1" as ULLONG_MAX
+    errno = 0;
+    v = strtoull(str, &end, 10);
+    if (end == str || *end || errno || v > max) return false;
+    *value = v;
+    return true;
+}
+
+static bool workload_load(workload_t* w)
+{
+    char line[256], size[64];
+    double weight;
+    FILE* f = fopen(w->hist_file.c_str(), "r");
+    if (!f) return false;
+
+    while (fgets(line, sizeof(line), f))
+    {
+        uint64_t s;
+        if (line[0] == '#' || sscanf(line, "%63s %lf", size, &weight) != 2) continue;
+        if (!workload_size(size, &s) || !s || weight <= 0) { fclose(f); return false; }
+        w->hist_sizes.push_back(s);
+        w->hist_weights.push_back(weight);
+    }
+    fclose(f);
+    return !w->hist_sizes.empty();
+}
+
+
+bool workload_parse(const char* spec, workload_t* w)
+{
+    std::string s(spec);
+    size_t start = 0;
+
+    w->hist_file.clear();
+    w->hist_sizes.clear();
+    w->hist_weights.clear();
+    w->median = WORKLOAD_DEFAULT_MEDIAN;
+    w->sigma = WORKLOAD_DEFAULT_SIGMA;
+    w->min_size = WORKLOAD_DEFAULT_MIN;
+    w->max_size = WORKLOAD_DEFAULT_MAX;
+    w->rate = 0;
+    w->count = WORKLOAD_DEFAULT_COUNT;
+    w->seed = 1;
+
+    for (int first = 1; start <= s.size(); first = 0)
+    {
+        size_t end = s.find(',', start);
+        if (end == std::string::npos) end = s.size();
+        std::string token = s.substr(start, end - start), key = token, value;
+        size_t eq = token.find('=');
+        uint64_t size, n;
+        double d;
+        start = end + 1;
+
+        if (eq != std::string::npos) { key = token.substr(0, eq); value = token.substr(eq + 1); }
+        if (first && token == "lognormal") continue;
+        if (first && key == "hist") { w->hist_file = value; continue; }
+        if (first || value.empty()) return false;
+
+        if (key == "median" && workload_size(value.c_str(), &size)) w->median = (double)size;
+        else if (key == "sigma" && workload_number(value.c_str(), WORKLOAD_MAX_SIGMA, &d)) w->sigma = d;
+        else if (key == "min" && workload_size(value.c_str(), &size)) w->min_size = size;
+        else if (key == "max" && workload_size(value.c_str(), &size)) w->max_size = size;
+        else if (key == "rate" && workload_number(value.c_str(), WORKLOAD_MAX_RATE, &d)) w->rate = d;
+        else if (key == "count" && workload_integer(value.c_str(), WORKLOAD_MAX_COUNT, &n)) w->count = (uint32_t)n;
+        else if (key == "seed" && workload_integer(value.c_str(), UINT64_MAX, &n)) w->seed = n;
+        else return false;
+    }
+    if (!w->hist_file.empty() && !workload_load(w)) return false;
+    return w->median >= 1 && w->sigma >= 0 && w->min_size >= 1 && w->min_size <= w->max_size && w->rate >= 0 && w->count > 0;
+}
+
+
+void workload_sizes(const workload_t* w, size_t insize, std::vector<size_t>& sizes)
+{
+    uint64_t state = w->seed;
+    double total = 0;
+
+    for (size_t i=0; i<w->hist_weights.size(); i++) total += w->hist_weights[i];
+    sizes.clear();
+    for (uint32_t r=0; r<w->count; r++)
+    {
+        double size;
+        if (w->hist_sizes.empty())
+        {
+            // Box-Muller, the size is exp(N(ln median, sigma))
+            double n = sqrt(-2.0 * log(workload_uniform(&state))) * cos(6.283185307179586 * workload_uniform(&state));
+            size = w->median * exp(w->sigma * n);
+        }
+        else
+        {
+            double pick = workload_uniform(&state) * total;
+            size_t i = 0;
+            while (i + 1 < w->hist_sizes.size() && pick >= w->hist_weights[i]) pick -= w->hist_weights[i++];
+            size = (double)w->hist_sizes[i];
+        }
+        size = (size < w->min_size) ? w->min_size : (size > w->max_size) ? w->max_size : size;
+        sizes.push_back((size > insize) ? insize : (size_t)size);
+    }
+}
+
+
+void workload_arrivals(const workload_t* w, size_t count, std::vector<uint64_t>& arrivals)
+{
+    uint64_t state = w->seed ^ 0x5DEECE66DULL;
+    double t = 0;
+
+    arrivals.clear();
+    for (size_t i=0; i<count; i++)
+    {
+        arrivals.push_back((uint64_t)t);
+        if (w->rate > 0) t += -log(workload_uniform(&state)) * 1e9 / w->rate;  // exponential gaps
+    }
+}
+
+
+int workload_bucket(size_t size)
+{
+    int b = 0;
+    for (size_t limit = 1 << 10; b < WORKLOAD_BUCKETS - 1 && size >= limit; limit *= 10) b++;  // 1 KB, 10 KB, ... of 1024 bytes
+    return b;
+}
+
+
+uint64_t workload_percentile(const std::vector<uint64_t>& sorted, double pct)
+{
+    if (sorted.empty()) return 0;
+    size_t i = (size_t)ceil(pct / 100.0 * sorted.size());
+    return sorted[(i > 0) ? i - 1 : 0];
+}
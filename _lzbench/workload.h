@@ -0,0 +1,55 @@
+#ifndef LZBENCH_WORKLOAD_H
+#define LZBENCH_WORKLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * Request workloads of the --workload option. Request sizes are drawn from a lognormal distribution or
+ * from a histogram file with "size weight" lines (sizes may have K, M or G suffixes; each request takes
+ * a size of a randomly chosen line), limited to [min, max]. The input is sliced into consecutive
+ * requests of these sizes, starting again at its beginning when a request doesn't fit. Requests arrive
+ * as a Poisson process at the given rate (open loop) or one after the other (closed loop, rate 0).
+ * The sizes, the arrival times and so the results depend only on the parameters and the seed.
+ */
+#define WORKLOAD_DEFAULT_MEDIAN 4096
+#define WORKLOAD_DEFAULT_SIGMA 2.0     // of the natural logarithm of the size, a long tail
+#define WORKLOAD_DEFAULT_MIN 100
+#define WORKLOAD_DEFAULT_MAX (16<<20)
+#define WORKLOAD_DEFAULT_COUNT 1000
+#define WORKLOAD_MAX_COUNT 100000000  // requests of one pass
+#define WORKLOAD_MAX_SIGMA 10.0
+#define WORKLOAD_MAX_RATE 1e9          // requests per second
+#define WORKLOAD_BUCKETS 6             // sizes below 1 KB, 10 KB, 100 KB, 1 MB, 10 MB and above
+
+typedef struct
+{
+    std::string hist_file;             // empty for the lognormal distribution
+    std::vector<uint64_t> hist_sizes;
+    std::vector<double> hist_weights;
+    double median, sigma;
+    uint64_t min_size, max_size;
+    double rate;                       // requests per second, 0 = closed loop
+    uint32_t count;                    // requests of one pass
+    uint64_t seed;
+} workload_t;
+
+/* lognormal[,median=#][,sigma=#] or hist=file, then [,min=#][,max=#][,rate=#][,count=#][,seed=#];
+   false if the spec or the histogram file is invalid */
+bool workload_parse(const char* spec, workload_t* w);
+
+/* the sizes of the requests of one pass, none over insize */
+void workload_sizes(const workload_t* w, size_t insize, std::vector<size_t>& sizes);
+
+/* the times in ns from the start of the pass at which the requests arrive, all 0 in closed loop */
+void workload_arrivals(const workload_t* w, size_t count, std::vector<uint64_t>& arrivals);
+
+int workload_bucket(size_t size);
+extern const char* workload_bucket_names[WORKLOAD_BUCKETS];
+
+/* the value below which pct % of the sorted samples are */
+uint64_t workload_percentile(const std::vector<uint64_t>& sorted, double pct);
+
+#endif
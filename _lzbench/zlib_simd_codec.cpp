@@ -0,0 +1,26 @@
+// has to be compiled separated because zlib_simd uses the prefixed (Z_PREFIX) zlib API
+
+#ifndef BENCH_REMOVE_ZLIB
+#include "compressors.h"
+#define Z_PREFIX
+#include "zlib/zlib.h"
+
+int64_t lzbench_zlib_simd_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, char*)
+{
+	uLongf zcomplen = insize;
+	int err = compress2((uint8_t*)outbuf, &zcomplen, (uint8_t*)inbuf, insize, level);
+	if (err != Z_OK)
+		return 0;
+	return zcomplen;
+}
+
+int64_t lzbench_zlib_simd_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t, size_t, char*)
+{
+	uLongf zdecomplen = outsize;
+	int err = uncompress((uint8_t*)outbuf, &zdecomplen, (uint8_t*)inbuf, insize);
+	if (err != Z_OK)
+		return 0;
+	return outsize;
+}
+
+#endif
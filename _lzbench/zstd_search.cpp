@@ -0,0 +1,72 @@
+// parameter space of zstd_adv for the --zstd-search option
+
+#include "zstd_search.h"
+#include <stdio.h>
+
+#ifndef BENCH_REMOVE_ZSTD
+#define ZSTD_STATIC_LINKING_ONLY
+#include "zstd/lib/zstd.h"
+
+static const ZSTD_cParameter zstd_search_params[ZSTD_SEARCH_DIMS] = { ZSTD_c_windowLog, ZSTD_c_chainLog, ZSTD_c_hashLog,
+    ZSTD_c_searchLog, ZSTD_c_minMatch, ZSTD_c_targetLength, ZSTD_c_strategy };
+#endif
+
+const char* zstd_search_keys[ZSTD_SEARCH_DIMS] = { "wlog", "clog", "hlog", "slog", "mml", "tlen", "strat" };
+
+
+int zstd_search_start(int level, size_t chunk_size, zstd_point_t* p)
+{
+#ifndef BENCH_REMOVE_ZSTD
+    ZSTD_compressionParameters c = ZSTD_getCParams(level, chunk_size, 0);
+    p->v[0] = c.windowLog;
+    p->v[1] = c.chainLog;
+    p->v[2] = c.hashLog;
+    p->v[3] = c.searchLog;
+    p->v[4] = c.minMatch;
+    p->v[5] = c.targetLength;
+    p->v[6] = c.strategy;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+
+int zstd_search_neighbours(const zstd_point_t* p, zstd_point_t* out)
+{
+    int count = 0;
+#ifndef BENCH_REMOVE_ZSTD
+    for (int d=0; d<ZSTD_SEARCH_DIMS; d++)
+    {
+        ZSTD_bounds bounds = ZSTD_cParam_getBounds(zstd_search_params[d]);
+        int steps[2];
+
+        if (d == 5)
+        {
+            steps[0] = p->v[d] ? p->v[d] * 2 : 1;
+            steps[1] = p->v[d] / 2;
+        }
+        else
+        {
+            steps[0] = p->v[d] + 1;
+            steps[1] = p->v[d] - 1;
+        }
+        for (int s=0; s<2; s++)
+        {
+            if (steps[s] == p->v[d] || steps[s] < bounds.lowerBound || steps[s] > bounds.upperBound) continue;
+            out[count] = *p;
+            out[count].v[d] = steps[s];
+            count++;
+        }
+    }
+#endif
+    return count;
+}
+
+
+void zstd_search_format(const zstd_point_t* p, char* buf, size_t size)
+{
+    snprintf(buf, size, "%s=%d,%s=%d,%s=%d,%s=%d,%s=%d,%s=%d,%s=%d", zstd_search_keys[0], p->v[0], zstd_search_keys[1], p->v[1],
+        zstd_search_keys[2], p->v[2], zstd_search_keys[3], p->v[3], zstd_search_keys[4], p->v[4], zstd_search_keys[5], p->v[5],
+        zstd_search_keys[6], p->v[6]);
+}
@@ -0,0 +1,31 @@
+#ifndef LZBENCH_ZSTD_SEARCH_H
+#define LZBENCH_ZSTD_SEARCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Parameter space of zstd_adv for the --zstd-search option. A point holds the ZSTD_compressionParameters
+ * in the order of zstd_search_keys and is written as the key=value list of -ezstd_adv. Its neighbours
+ * differ in one parameter by one step (tlen doubles or halves), as in the local search of paramgrill.
+ */
+#define ZSTD_SEARCH_DIMS 7
+#define ZSTD_SEARCH_MAX_POINTS 400   // compressions measured by one search
+
+typedef struct
+{
+    int v[ZSTD_SEARCH_DIMS];
+} zstd_point_t;
+
+extern const char* zstd_search_keys[ZSTD_SEARCH_DIMS];
+
+/* the parameters zstd selects for the level and chunk size, returns 0 without zstd */
+int zstd_search_start(int level, size_t chunk_size, zstd_point_t* p);
+
+/* writes the valid neighbours of p to out (2 * ZSTD_SEARCH_DIMS entries), returns their count */
+int zstd_search_neighbours(const zstd_point_t* p, zstd_point_t* out);
+
+/* the key=value list of p for -ezstd_adv */
+void zstd_search_format(const zstd_point_t* p, char* buf, size_t size);
+
+#endif
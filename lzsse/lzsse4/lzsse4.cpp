@@ -1497,3 +1497,361 @@ MATCH_UNDERFLOW:
 
     return outputCursor - output;
 }
+
+#if defined(__GNUC__)
+// Decodes the low and high nibbles of a control block in one 256-bit register (low lane Lo, high lane Hi) and leaves
+// the same per-nibble vectors as the SSE4.1 loops, so the DECODE_STEP macros above are shared unchanged.
+#define LZSSE4_DECODE_CONTROL_AVX2()                                                                                            \
+    __m128i controlBlock       = _mm_loadu_si128( reinterpret_cast<const __m128i*>( inputCursor ) );                          \
+    __m256i control            = _mm256_and_si256( _mm256_srlv_epi32( _mm256_broadcastsi128_si256( controlBlock ), nibbleShift ), nibbleMask256 ); \
+    __m256i carry              = _mm256_cmpeq_epi8( control, nibbleMask256 );                                                  \
+    __m128i carryLo            = _mm256_castsi256_si128( carry );                                                              \
+    __m128i carryHi            = _mm256_extracti128_si256( carry, 1 );                                                         \
+    __m128i shiftedCarryHi     = _mm_alignr_epi8( carryHi, previousCarryHi, 15 );                                              \
+                                                                                                                                \
+    previousCarryHi = carryHi;                                                                                                  \
+                                                                                                                                \
+    __m256i carryIn            = _mm256_inserti128_si256( _mm256_castsi128_si256( shiftedCarryHi ), carryLo, 1 );              \
+    __m256i isLiteral          = _mm256_cmpgt_epi8( literalsPerControl256, control );                                          \
+    __m256i fromLiteral256     = _mm256_andnot_si256( carryIn, isLiteral );                                                    \
+    __m256i bytesOut           = _mm256_sub_epi8( control, fromLiteral256 );                                                   \
+    __m256i streamBytesRead    = _mm256_andnot_si256( carryIn, _mm256_blendv_epi8( offsetSize256, bytesOut, isLiteral ) );    \
+    __m256i readOffset         = _mm256_xor_si256( _mm256_or_si256( isLiteral, carryIn ), _mm256_set1_epi8( -1 ) );           \
+                                                                                                                                \
+    __m128i bytesOutLo         = _mm256_castsi256_si128( bytesOut );                                                           \
+    __m128i bytesOutHi         = _mm256_extracti128_si256( bytesOut, 1 );                                                      \
+    __m128i streamBytesReadLo  = _mm256_castsi256_si128( streamBytesRead );                                                    \
+    __m128i streamBytesReadHi  = _mm256_extracti128_si256( streamBytesRead, 1 );                                               \
+    __m128i readOffsetLo       = _mm256_castsi256_si128( readOffset );                                                         \
+    __m128i readOffsetHi       = _mm256_extracti128_si256( readOffset, 1 );                                                    \
+    __m128i fromLiteralLo      = _mm256_castsi256_si128( fromLiteral256 );                                                     \
+    __m128i fromLiteralHi      = _mm256_extracti128_si256( fromLiteral256, 1 );
+// Same decoder and bitstream as LZSSE4_Decompress, but compiled for AVX2 (VEX encoded) with the control block preprocessing
+// done in 256-bit registers. The caller has to check that the CPU supports AVX2.
+__attribute__((target("avx2")))
+size_t LZSSE4_Decompress_AVX2( const void* inputChar, size_t inputLength, void* outputChar, size_t outputLength )
+{
+    const uint8_t* input  = reinterpret_cast< const uint8_t* >( inputChar );
+    uint8_t*       output = reinterpret_cast< uint8_t* >( outputChar );
+
+    // Data was not compressible, just copy initial values
+    if ( outputLength == inputLength )
+    {
+        memcpy( output, input, outputLength );
+
+        return inputLength;
+    }
+
+    const uint8_t* inputCursor  = input;
+    uint8_t*       outputCursor = output;
+
+    // The offset starts off as the minimum match length. We actually need it least four
+    // characters back because we need them to be set to xor out the literals from the match data.
+    size_t  offset          = INITIAL_OFFSET;
+    __m128i previousCarryHi = _mm_setzero_si128();
+
+    // Copy the initial literals to the output.
+    for ( uint32_t where = 0; where < MIN_MATCH_LENGTH; ++where )
+    {
+        *( outputCursor++ ) = *( inputCursor++ );
+    }
+
+    // Let me be clear, I am usually anti-macro, but they work for this particular (very unusual) case.  
+    // DECODE_STEP is a regular decoding step, DECODE_STEP_HALF and DECODE_STEP_END are because the compiler couldn't
+    // seem to remove some of the dead code where values were updated and then never used.
+
+    // What these macros do:
+    //     Decode a single literal run or match run for a single control nibble.
+    // How they do it:
+    //    - Read the *unaligned* input (in the case of LZSSE-F - twice), it goes into both a regular variable and an SSE register,
+    //      because it could either be literals or an offset (or nothing at all). The low byte of streamBytesRead controls how much we advance
+    //      the input cursor.
+    //    - Used a contived set of casts to sign extend the "read offset" control mask and then use it to mask the input word,
+    //      which is then xor'd against the offset, for a "branchless" conditional move into the offset which
+    //      has been carried over from the previous literal/match block. Note, this ends up doing better than a cmov on most 
+    //      modern processors. But we need to pre-xor the input offset.
+    //    - We then load the match data from output buffer (offset back from the current output point). Unconditional load here.
+    //    - We broadcast the "from literal" control mask from the current least significant byte of the SSE register using a shuffle epi-8
+    //    - We mask the literals with that SSE register wide mask.
+    //    - The literals have been pre-xor'd with the data read in as match data, so we use an xor to branchlessly choose between the two.
+    //      In this case, it ends up a better option than a blendv on most processors.
+    //    - Store the block. We store all 16 bytes of the SSE register (due to some constraints in the format of the data, we won't
+    //      go past the end of the buffer), but we may overlap this.
+    //    - bytesOut controls how much we advance the output cursor.
+    //    - We use 8 bit shifts to advance all the controls up to the next byte. There is some variable sized register trickery that 
+    //      x86/x64 is great for as long as we don't anger the register renamer.
+
+    __m256i nibbleMask256         = _mm256_set1_epi8( 0xF );
+    __m256i nibbleShift           = _mm256_setr_epi32( 0, 0, 0, 0, CONTROL_BITS, CONTROL_BITS, CONTROL_BITS, CONTROL_BITS );
+    __m256i offsetSize256         = _mm256_set1_epi8( OFFSET_SIZE );
+    __m256i literalsPerControl256 = _mm256_add_epi8( offsetSize256, offsetSize256 );
+
+    // Note, we use this block here because it allows the "fake" inputEarlyEnd/outputEarlyEnd not to cause register spills 
+    // in the decompression loops. And yes, that did actually happen.
+    {
+
+#pragma warning ( push )
+#pragma warning ( disable : 4101 )
+
+        // These variables are not actually ever used in this block, because we use
+        // a constant conditional expression to take out the branches that would hit them.
+        // But unfortunately, we need them to compile.
+        const  uint8_t* inputEarlyEnd;
+        uint8_t*        outputEarlyEnd;
+
+#pragma warning ( pop )
+
+        // "Safe" ends to the buffer, before the input/output cursors hit these, we can loop without overflow checks.
+        const  uint8_t* inputSafeEnd  = ( input + inputLength ) - INPUT_BUFFER_SAFE;
+        uint8_t*        outputSafeEnd = ( output + outputLength ) - OUTPUT_BUFFER_SAFE;
+
+        // Decoding loop with offset output buffer underflow test, but no buffer overflow tests, assumed to end at a safe distance 
+        // from overflows
+        while ( ( outputCursor - output ) < LZ_WINDOW_SIZE && outputCursor < outputSafeEnd && inputCursor < inputSafeEnd )
+        {
+            LZSSE4_DECODE_CONTROL_AVX2();
+
+            // Advance the input past the control block
+            inputCursor += CONTROL_BLOCK_SIZE;
+
+            {
+                // Pull out the bottom halves off the SSE registers from before - we want these
+                // things in GPRs for the more linear logic.
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutLo ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutHi ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadLo ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadHi ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetLo ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetHi ) );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_HALF_LO( true, false );
+                DECODE_STEP_HALF_HI( true, false );
+            }
+
+            {
+                // Now the top halves.
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutLo, 1 ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutHi, 1 ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadLo, 1 ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadHi, 1 ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetLo, 1 ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetHi, 1 ) );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+
+                DECODE_STEP_LO( true, false );
+                DECODE_STEP_HI( true, false );
+                DECODE_STEP_END_LO( true, false );
+                DECODE_STEP_END_HI( true, false );
+            }
+        }
+
+        // Decoding loop with no buffer checks, but will end at a safe distance from the end of the buffers.
+        // Note, when we get here we have already reached the point in the output buffer which is *past* where we can underflow
+        // due to a bad match offset.
+        while ( outputCursor < outputSafeEnd && inputCursor < inputSafeEnd )
+        {
+            LZSSE4_DECODE_CONTROL_AVX2();
+
+            inputCursor += CONTROL_BLOCK_SIZE;
+
+            {
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutLo ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutHi ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadLo ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadHi ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetLo ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetHi ) );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_HALF_LO( false, false );
+                DECODE_STEP_HALF_HI( false, false );
+            }
+
+            {
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutLo, 1 ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutHi, 1 ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadLo, 1 ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadHi, 1 ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetLo, 1 ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetHi, 1 ) );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+
+                DECODE_STEP_LO( false, false );
+                DECODE_STEP_HI( false, false );
+                DECODE_STEP_END_LO( false, false );
+                DECODE_STEP_END_HI( false, false );
+            }
+        }
+    }
+
+    // Decoding loop with all buffer checks.
+    {
+        const  uint8_t* inputEarlyEnd;
+        uint8_t*        outputEarlyEnd;
+        inputEarlyEnd  = ( input + inputLength ) - END_PADDING_LITERALS;
+        outputEarlyEnd = ( output + outputLength ) - END_PADDING_LITERALS;
+
+        while ( outputCursor < outputEarlyEnd && inputCursor < inputEarlyEnd )
+        {
+            LZSSE4_DECODE_CONTROL_AVX2();
+
+            inputCursor += CONTROL_BLOCK_SIZE;
+
+            if ( inputCursor > inputEarlyEnd )
+                goto BUFFER_END;
+
+            {
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutLo ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_cvtsi128_si64( bytesOutHi ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadLo ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_cvtsi128_si64( streamBytesReadHi ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetLo ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_cvtsi128_si64( readOffsetHi ) );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_HALF_LO( true, true );
+                DECODE_STEP_HALF_HI( true, true );
+            }
+
+            {
+                // Now the top halves.
+                uint64_t bytesOutHalfLo        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutLo, 1 ) );
+                uint64_t bytesOutHalfHi        = static_cast<uint64_t>( _mm_extract_epi64( bytesOutHi, 1 ) );
+
+                uint64_t streamBytesReadHalfLo = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadLo, 1 ) );
+                uint64_t streamBytesReadHalfHi = static_cast<uint64_t>( _mm_extract_epi64( streamBytesReadHi, 1 ) );
+
+                uint64_t readOffsetHalfLo      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetLo, 1 ) );
+                uint64_t readOffsetHalfHi      = static_cast<uint64_t>( _mm_extract_epi64( readOffsetHi, 1 ) );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+
+                DECODE_STEP_LO( true, true );
+                DECODE_STEP_HI( true, true );
+                DECODE_STEP_END_LO( true, true );
+                DECODE_STEP_END_HI( true, true );
+            }
+        }
+
+BUFFER_END:
+
+        // When we get here, we have either advanced the right amount on both cursors
+        // or something bad happened, so leave it as is, so we can tell where
+        // the error happened. 
+        if ( inputCursor == inputEarlyEnd && outputCursor == outputEarlyEnd )
+        {
+            size_t remainingLiterals = ( input + inputLength ) - inputCursor;
+
+            // copy any trailing literals
+            memcpy( outputCursor, inputCursor, remainingLiterals );
+
+            outputCursor += remainingLiterals;
+        }
+    }
+
+MATCH_UNDERFLOW:
+
+    return outputCursor - output;
+}
+
+#endif
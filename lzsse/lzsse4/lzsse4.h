@@ -110,6 +110,13 @@ size_t LZSSE4_CompressFast( LZSSE4_FastParseState* state, const void* input, siz
  */ 
 size_t LZSSE4_Decompress( const void* input, size_t inputLength, void* output, size_t outputLength );
 
+/* The same decompression routine compiled for AVX2, the control blocks are decoded in 256-bit registers.
+* The stream format is unchanged. The caller has to check that the CPU supports AVX2. GCC and Clang only.
+*/
+#if defined(__GNUC__)
+size_t LZSSE4_Decompress_AVX2( const void* input, size_t inputLength, void* output, size_t outputLength );
+#endif
+
 #ifdef __cplusplus
 }
 #endif
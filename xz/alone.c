@@ -1,13 +1,46 @@
 #include "common.h"
 #include "alone.h"
 
-int64_t xz_alone_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t x, size_t y)
+static int xz_alone_options(lzma_options_lzma *opt_lzma, size_t level, size_t options)
+{
+	static const lzma_match_finder mf[] = { LZMA_MF_HC3, LZMA_MF_HC4, LZMA_MF_BT2, LZMA_MF_BT3, LZMA_MF_BT4 };
+	const int* o = (const int*)options;
+  	uint32_t preset = level; // preset |= LZMA_PRESET_EXTREME;
+
+	if (lzma_lzma_preset(opt_lzma, preset))
+		return 0;
+	if (o)
+	{
+		if (o[0] >= 0) opt_lzma->dict_size = (o[0] < 32) ? (uint32_t)1 << o[0] : 0;
+		if (o[1] >= 0) opt_lzma->lc = o[1];
+		if (o[2] >= 0) opt_lzma->lp = o[2];
+		if (o[3] >= 0) opt_lzma->pb = o[3];
+		if (o[4] >= 0) opt_lzma->mode = (lzma_mode)o[4];
+		if (o[5] >= 0) opt_lzma->nice_len = o[5];
+		if (o[6] >= 0) opt_lzma->mf = (o[6] < 5) ? mf[o[6]] : (lzma_match_finder)0;
+		if (o[7] >= 0) opt_lzma->depth = o[7];
+	}
+	return 1;
+}
+
+int xz_alone_options_valid(size_t level, size_t options)
+{
+	lzma_options_lzma opt_lzma;
+
+	if (!xz_alone_options(&opt_lzma, level, options))
+		return 0;
+	if (opt_lzma.lc + opt_lzma.lp > LZMA_LCLP_MAX)
+		return 0;
+	// the match finders need nice_len of at least the bytes they hash: hc3 bt3 3, hc4 bt4 4, bt2 2
+	return opt_lzma.nice_len >= (opt_lzma.mf & 0x0F);
+}
+
+int64_t xz_alone_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t options, size_t y)
 {
     lzma_options_lzma opt_lzma;
     lzma_stream strm = LZMA_STREAM_INIT;
-  	uint32_t preset = level; // preset |= LZMA_PRESET_EXTREME;
 
-	if (lzma_lzma_preset(&opt_lzma, preset))
+	if (!xz_alone_options(&opt_lzma, level, options))
 		return 0;
 
 	lzma_ret ret = lzma_alone_encoder(&strm, &opt_lzma);
@@ -5,7 +5,12 @@
 extern "C"
 {
 #endif
-    int64_t xz_alone_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t, size_t);
+    /* options points to XZ_ALONE_OPTIONS values (dict as log2, lc, lp, pb, mode, nice_len, mf as hc3/hc4/bt2/bt3/bt4 = 0-4, depth)
+       that replace those of the preset unless -1, or is 0 */
+    #define XZ_ALONE_OPTIONS 8
+    int64_t xz_alone_compress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t options, size_t);
+    /* 0 if the options with the preset of level break the limits that span several values (lc + lp, nice_len of mf) */
+    int xz_alone_options_valid(size_t level, size_t options);
     int64_t xz_alone_decompress(char *inbuf, size_t insize, char *outbuf, size_t outsize, size_t level, size_t x, size_t y);
 #if defined (__cplusplus) 
 }
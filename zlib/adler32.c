@@ -6,6 +6,9 @@
 /* @(#) $Id$ */
 
 #include "zutil.h"
+#ifdef ZLIB_SIMD
+#  include "simd.h"
+#endif
 
 local uLong adler32_combine_ OF((uLong adler1, uLong adler2, z_off64_t len2));
 
@@ -68,6 +71,12 @@ uLong ZEXPORT adler32_z(adler, buf, len)
     unsigned long sum2;
     unsigned n;
 
+#ifdef ZLIB_SIMD_X86
+    Z_SIMD_CPU_CHECK();
+    if (buf != Z_NULL && len >= Z_SIMD_MIN_LENGTH && z_simd_has_ssse3)
+        return adler32_simd(adler, buf, len);
+#endif
+
     /* split Adler-32 into component sums */
     sum2 = (adler >> 16) & 0xffff;
     adler &= 0xffff;
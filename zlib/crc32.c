@@ -29,6 +29,9 @@
 #endif /* MAKECRCH */
 
 #include "zutil.h"      /* for STDC and FAR definitions */
+#ifdef ZLIB_SIMD
+#  include "simd.h"
+#endif
 
 /* Definitions for doing the crc four data bytes at a time. */
 #if !defined(NOBYFOUR) && defined(Z_U4)
@@ -211,6 +214,18 @@ unsigned long ZEXPORT crc32_z(crc, buf, len)
         make_crc_table();
 #endif /* DYNAMIC_CRC_TABLE */
 
+#ifdef ZLIB_SIMD_X86
+    Z_SIMD_CPU_CHECK();
+    if (len >= Z_SIMD_MIN_LENGTH && z_simd_has_pclmul) {
+        z_size_t blocks = len & ~(z_size_t)15;
+        crc = ~crc32_pclmul(~(unsigned)crc, buf, blocks) & 0xffffffffUL;
+        buf += blocks;
+        len -= blocks;
+        if (len == 0)
+            return crc;
+    }
+#endif
+
 #ifdef BYFOUR
     if (sizeof(void *) == sizeof(ptrdiff_t)) {
         z_crc_t endian;
@@ -76,6 +76,9 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     unsigned len;               /* match length, unused bytes */
     unsigned dist;              /* match distance */
     unsigned char FAR *from;    /* where to copy match from */
+#ifdef ZLIB_SIMD
+    unsigned char FAR *limit;   /* end of the output buffer */
+#endif
 
     /* copy state to local variables */
     state = (struct inflate_state FAR *)strm->state;
@@ -84,6 +87,9 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
     out = strm->next_out;
     beg = out - (start - strm->avail_out);
     end = out + (strm->avail_out - 257);
+#ifdef ZLIB_SIMD
+    limit = out + strm->avail_out;
+#endif
 #ifdef INFLATE_STRICT
     dmax = state->dmax;
 #endif
@@ -250,6 +256,29 @@ unsigned start;         /* inflate()'s starting value for strm->avail_out */
                 }
                 else {
                     from = out - dist;          /* copy direct from output */
+#ifdef ZLIB_SIMD
+                    /* copy in 16 or 8 byte chunks when they do not overlap
+                       the bytes being written, this may write up to 15 bytes
+                       past the match but never past the output buffer */
+                    if (dist >= 8 && (unsigned)(limit - out) >= len + 16) {
+                        unsigned char FAR *stop = out + len;
+                        if (dist >= 16)
+                            do {
+                                zmemcpy(out, from, 16);
+                                out += 16;
+                                from += 16;
+                            } while (out < stop);
+                        else
+                            do {
+                                zmemcpy(out, from, 8);
+                                out += 8;
+                                from += 8;
+                            } while (out < stop);
+                        out = stop;
+                        len = 0;
+                    }
+                    else
+#endif
                     do {                        /* minimum length is three */
                         *out++ = *from++;
                         *out++ = *from++;
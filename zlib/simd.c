@@ -0,0 +1,258 @@
+/* simd.c -- x86 SIMD kernels of the ZLIB_SIMD build (lzbench "zlib_simd")
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ *
+ * adler32: the Chromium zlib SSSE3 method (sums of 32-byte blocks with
+ *   psadbw for the plain sum and pmaddubsw with the weights 32..1 for the
+ *   weighted sum), and an AVX2 variant of it
+ * crc32: folding of 4x128 bits with carry-less multiplication and a Barrett
+ *   reduction, see "Fast CRC Computation for Generic Polynomials Using
+ *   PCLMULQDQ Instruction", Intel 2009
+ * hash: the SSE4.2 crc32 instruction over 4 bytes
+ */
+
+#include "simd.h"
+
+#ifdef ZLIB_SIMD_X86
+
+#include <stdint.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+int ZLIB_INTERNAL z_simd_cpu_checked = 0;
+int ZLIB_INTERNAL z_simd_has_ssse3 = 0;
+int ZLIB_INTERNAL z_simd_has_avx2 = 0;
+int ZLIB_INTERNAL z_simd_has_pclmul = 0;
+int ZLIB_INTERNAL z_simd_has_crc32c = 0;
+
+void ZLIB_INTERNAL z_simd_cpu_check()
+{
+    unsigned eax, ebx, ecx, edx;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        z_simd_has_ssse3 = (ecx >> 9) & 1;
+        z_simd_has_pclmul = ((ecx >> 1) & 1) && ((ecx >> 19) & 1);
+        z_simd_has_crc32c = (ecx >> 20) & 1;
+
+        /* AVX2 also needs the OS to save the YMM registers (OSXSAVE + XCR0) */
+        if (((ecx >> 27) & 1) && ((ecx >> 28) & 1) && __get_cpuid_max(0, 0) >= 7) {
+            unsigned xcr0_lo, xcr0_hi;
+            __asm__ ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            z_simd_has_avx2 = ((xcr0_lo & 6) == 6) && ((ebx >> 5) & 1);
+        }
+    }
+    z_simd_cpu_checked = 1;
+}
+
+/* ========================================================================= */
+#define BASE 65521U     /* largest prime smaller than 65536 */
+#define NMAX 5552       /* see adler32.c */
+#define BLOCK_SIZE 32
+
+local uLong adler32_tail(unsigned long s1, unsigned long s2, const Bytef *buf, z_size_t len)
+{
+    while (len--) {
+        s1 += *buf++;
+        s2 += s1;
+    }
+    return (s1 % BASE) | ((s2 % BASE) << 16);
+}
+
+__attribute__((target("ssse3")))
+local uLong adler32_ssse3(uLong adler, const Bytef *buf, z_size_t len)
+{
+    unsigned long s1 = adler & 0xffff;
+    unsigned long s2 = (adler >> 16) & 0xffff;
+    z_size_t blocks = len / BLOCK_SIZE;
+    const __m128i tap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17);
+    const __m128i tap2 = _mm_setr_epi8(16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    len -= blocks * BLOCK_SIZE;
+    while (blocks) {
+        unsigned n = NMAX / BLOCK_SIZE;
+        __m128i v_ps, v_s1, v_s2;
+
+        if (n > blocks)
+            n = (unsigned)blocks;
+        blocks -= n;
+
+        /* v_ps sums s1 before each block, s1 is added 32 times per block to s2 */
+        v_ps = _mm_set_epi32(0, 0, 0, (int)(s1 * n));
+        v_s2 = _mm_set_epi32(0, 0, 0, (int)s2);
+        v_s1 = _mm_setzero_si128();
+        do {
+            const __m128i bytes1 = _mm_loadu_si128((const __m128i *)buf);
+            const __m128i bytes2 = _mm_loadu_si128((const __m128i *)(buf + 16));
+
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+            buf += BLOCK_SIZE;
+        } while (--n);
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* horizontal sums */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2,3,0,1)));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1,0,3,2)));
+        s1 += (unsigned)_mm_cvtsi128_si32(v_s1);
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2,3,0,1)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1,0,3,2)));
+        s2 = (unsigned)_mm_cvtsi128_si32(v_s2);
+
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+__attribute__((target("avx2")))
+local uLong adler32_avx2(uLong adler, const Bytef *buf, z_size_t len)
+{
+    unsigned long s1 = adler & 0xffff;
+    unsigned long s2 = (adler >> 16) & 0xffff;
+    z_size_t blocks = len / BLOCK_SIZE;
+    const __m256i tap = _mm256_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17,
+                                         16,15,14,13,12,11,10,9,8,7,6,5,4,3,2,1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    len -= blocks * BLOCK_SIZE;
+    while (blocks) {
+        unsigned n = NMAX / BLOCK_SIZE;
+        __m256i v_ps, v_s1, v_s2;
+        __m128i sum;
+
+        if (n > blocks)
+            n = (unsigned)blocks;
+        blocks -= n;
+
+        /* the same as the SSSE3 loop, one 32-byte load per block */
+        v_ps = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)(s1 * n));
+        v_s2 = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, (int)s2);
+        v_s1 = _mm256_setzero_si256();
+        do {
+            const __m256i bytes = _mm256_loadu_si256((const __m256i *)buf);
+
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+            buf += BLOCK_SIZE;
+        } while (--n);
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        sum = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2,3,0,1)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1,0,3,2)));
+        s1 += (unsigned)_mm_cvtsi128_si32(sum);
+        sum = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2,3,0,1)));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1,0,3,2)));
+        s2 = (unsigned)_mm_cvtsi128_si32(sum);
+
+        s1 %= BASE;
+        s2 %= BASE;
+    }
+    return adler32_tail(s1, s2, buf, len);
+}
+
+uLong ZLIB_INTERNAL adler32_simd(uLong adler, const Bytef *buf, z_size_t len)
+{
+    if (z_simd_has_avx2)
+        return adler32_avx2(adler, buf, len);
+    return adler32_ssse3(adler, buf, len);
+}
+
+/* ========================================================================= */
+__attribute__((target("pclmul,sse4.1")))
+unsigned ZLIB_INTERNAL crc32_pclmul(unsigned crc, const unsigned char FAR *buf, z_size_t len)
+{
+    /* constants of the reflected CRC-32 polynomial, from the Intel paper */
+    static const uint64_t __attribute__((aligned(16))) k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+    static const uint64_t __attribute__((aligned(16))) k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+    static const uint64_t __attribute__((aligned(16))) k5k0[] = { 0x0163cd6124, 0x0000000000 };
+    static const uint64_t __attribute__((aligned(16))) poly[] = { 0x01db710641, 0x01f7011641 };
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+    x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+    x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+    x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    x0 = _mm_load_si128((const __m128i *)k1k2);
+    buf += 64;
+    len -= 64;
+
+    /* fold 4x128 bits in parallel */
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
+
+    /* fold into 128 bits */
+    x0 = _mm_load_si128((const __m128i *)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* single folds of the remaining 128-bit blocks */
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)buf)), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    /* fold 128 to 64 bits */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* Barrett reduction to 32 bits */
+    x0 = _mm_load_si128((const __m128i *)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (unsigned)_mm_extract_epi32(x1, 1);
+}
+
+/* ========================================================================= */
+__attribute__((target("sse4.2")))
+unsigned ZLIB_INTERNAL crc32c_hash(const Bytef *p)
+{
+    unsigned val;
+    zmemcpy(&val, p, sizeof(val));
+    return _mm_crc32_u32(0, val);
+}
+
+#endif /* ZLIB_SIMD_X86 */
@@ -0,0 +1,40 @@
+/* simd.h -- x86 SIMD kernels of the ZLIB_SIMD build (lzbench "zlib_simd")
+ * For conditions of distribution and use, see copyright notice in zlib.h
+ *
+ * The ZLIB_SIMD build compiles the same sources with -DZ_PREFIX -DZLIB_SIMD,
+ * the kernels are selected at run time with cpuid, so the objects run on any
+ * x86 CPU and fall back to the portable code elsewhere.  The deflate streams
+ * stay standard, but the CRC32C hash finds different matches than the stock
+ * hash, so the compressed bytes differ from the stock zlib output.
+ */
+
+#ifndef ZLIB_SIMD_H
+#define ZLIB_SIMD_H
+
+#include "zutil.h"
+
+#if defined(ZLIB_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ZLIB_SIMD_X86
+
+#  define Z_SIMD_MIN_LENGTH 64  /* shorter buffers use the portable adler32/crc32 */
+
+extern int ZLIB_INTERNAL z_simd_cpu_checked;
+extern int ZLIB_INTERNAL z_simd_has_ssse3;   /* adler32 */
+extern int ZLIB_INTERNAL z_simd_has_avx2;    /* adler32 */
+extern int ZLIB_INTERNAL z_simd_has_pclmul;  /* crc32, with SSE4.1 */
+extern int ZLIB_INTERNAL z_simd_has_crc32c;  /* deflate hash, SSE4.2 */
+
+void ZLIB_INTERNAL z_simd_cpu_check OF((void));
+#  define Z_SIMD_CPU_CHECK() do { if (!z_simd_cpu_checked) z_simd_cpu_check(); } while (0)
+
+/* adler is the combined value, len >= Z_SIMD_MIN_LENGTH */
+uLong ZLIB_INTERNAL adler32_simd OF((uLong adler, const Bytef *buf, z_size_t len));
+
+/* crc is the pre-conditioned value, len must be a multiple of 16 and >= Z_SIMD_MIN_LENGTH */
+unsigned ZLIB_INTERNAL crc32_pclmul OF((unsigned crc, const unsigned char FAR *buf, z_size_t len));
+
+/* CRC32C of the 4 bytes at p, used as the deflate hash (masked by the caller) */
+unsigned ZLIB_INTERNAL crc32c_hash OF((const Bytef *p));
+#endif
+
+#endif /* ZLIB_SIMD_H */